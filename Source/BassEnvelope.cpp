@@ -0,0 +1,264 @@
+#include "BassEnvelope.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// How far past its end point each stage aims. A large attack overshoot gives the convex,
+// capacitor-charging rise of an analog envelope; the small decay/release ratios give ~60 dB curves.
+constexpr float attackOvershoot = 0.3f;
+constexpr float decayRatio = 0.001f;
+constexpr float releaseRatio = 0.001f;
+
+float segmentCoefficient(float timeSeconds, double sampleRate, float ratio)
+{
+    const double samples = std::max(1.0, static_cast<double>(timeSeconds) * sampleRate);
+    return static_cast<float>(std::pow(static_cast<double>(ratio / (1.0f + ratio)), 1.0 / samples));
+}
+}
+
+void BassEnvelope::setSampleRate(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    updateCoefficients();
+    enterStage(stage);
+}
+
+void BassEnvelope::setParameters(const Parameters& newParameters)
+{
+    if (newParameters == parameters && attackCoeff > 0.0f)
+        return;
+
+    parameters = newParameters;
+    updateCoefficients();
+
+    // Restart the running stage from the current level so the new times apply immediately.
+    enterStage(stage);
+}
+
+void BassEnvelope::updateCoefficients()
+{
+    attackCoeff = segmentCoefficient(parameters.attack, sampleRate, attackOvershoot);
+    decayCoeff = segmentCoefficient(parameters.decay, sampleRate, decayRatio);
+    releaseCoeff = segmentCoefficient(parameters.release, sampleRate, releaseRatio);
+}
+
+void BassEnvelope::reset()
+{
+    value = 0.0f;
+    releaseTarget = 0.0f;
+    enterStage(Stage::idle);
+}
+
+void BassEnvelope::noteOn()
+{
+    enterStage(Stage::attack);
+}
+
+void BassEnvelope::noteOff()
+{
+    if (stage == Stage::idle)
+        return;
+
+    releaseTarget = -releaseRatio * value;
+    enterStage(Stage::release);
+}
+
+void BassEnvelope::enterStage(Stage newStage)
+{
+    if (newStage == Stage::decay && value <= parameters.sustain)
+        newStage = Stage::sustain;
+
+    stage = newStage;
+
+    float coeff = 0.0f;
+    switch (stage)
+    {
+        case Stage::idle:
+        case Stage::sustain:
+            value = stage == Stage::idle ? 0.0f : parameters.sustain;
+            curveTarget = value;
+            curveBoundary = value;
+            curveStride = 0.0f;
+            curveLanes.fill(0.0f);
+            laneIndex = 0;
+            stageRemaining = 0;
+            return;
+
+        case Stage::attack:
+            curveTarget = 1.0f + attackOvershoot;
+            curveBoundary = 1.0f;
+            coeff = attackCoeff;
+            break;
+
+        case Stage::decay:
+            curveTarget = parameters.sustain - decayRatio * (1.0f - parameters.sustain);
+            curveBoundary = parameters.sustain;
+            coeff = decayCoeff;
+            break;
+
+        case Stage::release:
+            curveTarget = releaseTarget;
+            curveBoundary = 0.0f;
+            coeff = releaseCoeff;
+            break;
+    }
+
+    stageRemaining = samplesUntil(curveBoundary, curveTarget, coeff);
+
+    // Lane k starts k samples into the stage.
+    float power = coeff;
+    for (auto& lane : curveLanes)
+    {
+        lane = (value - curveTarget) * power;
+        power *= coeff;
+    }
+    curveStride = power / coeff;
+    laneIndex = 0;
+}
+
+int BassEnvelope::samplesUntil(float boundary, float target, float coeff) const
+{
+    const float distance = value - target;
+    if (std::fpclassify(distance) == FP_ZERO)
+        return 0;
+
+    const float ratio = (boundary - target) / distance;
+    if (ratio >= 1.0f)
+        return 0;
+    if (ratio <= 0.0f || coeff <= 0.0f)
+        return 1;
+
+    const double samples = std::ceil(std::log(static_cast<double>(ratio)) / std::log(static_cast<double>(coeff)));
+    return static_cast<int>(std::min(samples, 1.0e9));
+}
+
+int BassEnvelope::segmentLength() const
+{
+    return stage == Stage::idle || stage == Stage::sustain ? std::numeric_limits<int>::max() : stageRemaining;
+}
+
+BassEnvelope::Lanes BassEnvelope::loadLanes() const
+{
+    Lanes rotated;
+    for (int k = 0; k < lanes; ++k)
+        rotated[static_cast<size_t>(k)] = curveLanes[static_cast<size_t>((laneIndex + k) % lanes)];
+    return rotated;
+}
+
+void BassEnvelope::storeLanes(const Lanes& rotated, int count)
+{
+    for (int k = 0; k < lanes; ++k)
+        curveLanes[static_cast<size_t>((laneIndex + k) % lanes)] = rotated[static_cast<size_t>(k)];
+    laneIndex = (laneIndex + count) % lanes;
+}
+
+void BassEnvelope::finishSegment(float* dest, int count)
+{
+    if (segmentLength() == std::numeric_limits<int>::max())
+        return;
+
+    stageRemaining -= count;
+    if (count > 0)
+        value = dest[count - 1];
+
+    if (stageRemaining > 0)
+        return;
+
+    value = curveBoundary;
+    if (count > 0)
+        dest[count - 1] = value;
+
+    if (stage == Stage::attack)
+        enterStage(Stage::decay);
+    else if (stage == Stage::decay)
+        enterStage(Stage::sustain);
+    else
+        reset();
+}
+
+// Both fills step whole groups of four lanes, each multiplied by coeff^4, so there is no serial
+// dependency between neighbouring samples and the loops vectorise. Rotating the lanes on entry
+// keeps each lane's multiplication sequence the same wherever a call starts.
+void BassEnvelope::render(float* dest, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        const int count = std::min(numSamples, segmentLength());
+
+        auto offset = loadLanes();
+        const float target = curveTarget;
+        const float stride = curveStride;
+
+        int i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            for (int k = 0; k < lanes; ++k)
+            {
+                dest[i + k] = target + offset[static_cast<size_t>(k)];
+                offset[static_cast<size_t>(k)] *= stride;
+            }
+        }
+
+        for (int k = 0; i < count; ++i, ++k)
+        {
+            dest[i] = target + offset[static_cast<size_t>(k)];
+            offset[static_cast<size_t>(k)] *= stride;
+        }
+
+        storeLanes(offset, count);
+        finishSegment(dest, count);
+
+        dest += count;
+        numSamples -= count;
+    }
+}
+
+void BassEnvelope::renderPair(BassEnvelope& first, BassEnvelope& second, float* firstDest, float* secondDest, int numSamples)
+{
+    // Each pass runs until either envelope reaches the end of a stage.
+    while (numSamples > 0)
+    {
+        const int count = std::min({ numSamples, first.segmentLength(), second.segmentLength() });
+
+        auto firstOffset = first.loadLanes();
+        auto secondOffset = second.loadLanes();
+        const float firstTarget = first.curveTarget;
+        const float secondTarget = second.curveTarget;
+        const float firstStride = first.curveStride;
+        const float secondStride = second.curveStride;
+
+        int i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            for (int k = 0; k < lanes; ++k)
+            {
+                const auto lane = static_cast<size_t>(k);
+                firstDest[i + k] = firstTarget + firstOffset[lane];
+                secondDest[i + k] = secondTarget + secondOffset[lane];
+                firstOffset[lane] *= firstStride;
+                secondOffset[lane] *= secondStride;
+            }
+        }
+
+        for (int k = 0; i < count; ++i, ++k)
+        {
+            const auto lane = static_cast<size_t>(k);
+            firstDest[i] = firstTarget + firstOffset[lane];
+            secondDest[i] = secondTarget + secondOffset[lane];
+            firstOffset[lane] *= firstStride;
+            secondOffset[lane] *= secondStride;
+        }
+
+        first.storeLanes(firstOffset, count);
+        second.storeLanes(secondOffset, count);
+        first.finishSegment(firstDest, count);
+        second.finishSegment(secondDest, count);
+
+        firstDest += count;
+        secondDest += count;
+        numSamples -= count;
+    }
+}
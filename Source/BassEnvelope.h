@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+
+// ADSR with one-pole exponential segments, rendered a block at a time.
+//
+// Each stage is value = target + (value - target) * coeff^n, aimed slightly past its end point
+// (above 1 for attack, below sustain for decay, below 0 for release) so it lands there after
+// exactly the stage time. Because the curve is closed-form, the number of samples left in a
+// stage is known up front and whole segments are written without per-sample stage checks.
+//
+// The curve state lives in the envelope rather than being rebuilt per call, so the output is
+// bit-identical however a note is split into render calls. Idle and sustain are flat curves, so
+// every stage goes through the same fill loop and renderPair can step two envelopes together.
+class BassEnvelope
+{
+public:
+    struct Parameters
+    {
+        float attack = 0.01f;
+        float decay = 0.1f;
+        float sustain = 1.0f;
+        float release = 0.1f;
+
+        // Bitwise, so any change to a setting counts and no floats are compared for equality.
+        bool operator==(const Parameters& other) const
+        {
+            return std::memcmp(this, &other, sizeof(Parameters)) == 0;
+        }
+    };
+
+    void setSampleRate(double newSampleRate);
+    void setParameters(const Parameters& newParameters);
+    void reset();
+
+    // Starts the attack from the current level, so a retrigger never clicks back to zero.
+    void noteOn();
+    void noteOff();
+
+    bool isActive() const { return stage != Stage::idle; }
+
+    void render(float* dest, int numSamples);
+
+    // Renders two envelopes in one pass over the block, e.g. amp and filter envelopes of a voice.
+    // Output is identical to calling render() on each.
+    static void renderPair(BassEnvelope& first, BassEnvelope& second, float* firstDest, float* secondDest, int numSamples);
+
+private:
+    enum class Stage
+    {
+        idle,
+        attack,
+        decay,
+        sustain,
+        release
+    };
+
+    static constexpr int lanes = 4;
+    using Lanes = std::array<float, lanes>;
+
+    void updateCoefficients();
+    void enterStage(Stage newStage);
+    int samplesUntil(float boundary, float target, float coeff) const;
+
+    // Samples the current stage runs for before its end point, unbounded for idle and sustain.
+    int segmentLength() const;
+
+    // The lanes reordered so element 0 emits the next sample, and the inverse after count samples.
+    Lanes loadLanes() const;
+    void storeLanes(const Lanes& rotated, int count);
+
+    // Bookkeeping after count samples of the current stage were written to dest.
+    void finishSegment(float* dest, int count);
+
+    double sampleRate = 44100.0;
+    Parameters parameters;
+
+    Stage stage = Stage::idle;
+    float value = 0.0f;
+    float releaseTarget = 0.0f;
+
+    float attackCoeff = 0.0f;
+    float decayCoeff = 0.0f;
+    float releaseCoeff = 0.0f;
+
+    // Curve of the current stage, set up by enterStage. Lane k holds the offset from curveTarget
+    // of the next sample it will emit; laneIndex is the lane the next sample comes from. Idle and
+    // sustain have zero lanes, so they emit curveTarget.
+    float curveTarget = 0.0f;
+    float curveBoundary = 0.0f;
+    float curveStride = 0.0f;
+    Lanes curveLanes {};
+    int laneIndex = 0;
+    int stageRemaining = 0;
+};
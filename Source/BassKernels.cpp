@@ -0,0 +1,117 @@
+#include "BassKernels.h"
+
+#include <atomic>
+
+#include <juce_core/juce_core.h>
+
+#if DBASS_HAS_X86_KERNELS
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+namespace bass::kernels
+{
+namespace
+{
+#if DBASS_HAS_X86_KERNELS
+constexpr juce::uint64 ymmState = 0x06; // XMM and upper YMM halves.
+constexpr juce::uint64 zmmState = 0xe6; // Plus the opmask registers and the upper ZMM registers.
+
+// The register state the OS saves across context switches (XCR0), or 0 if it doesn't expose it.
+// The CPUID feature bits alone don't say whether wide registers may be used, e.g. in a VM.
+juce::uint64 osEnabledRegisterState()
+{
+   #if JUCE_MSVC
+    int info[4] {};
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0)
+        return 0;
+
+    return _xgetbv(0);
+   #else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 || (ecx & (1u << 27)) == 0)
+        return 0;
+
+    unsigned int low = 0, high = 0;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<juce::uint64>(high) << 32) | low;
+   #endif
+}
+
+bool osEnables(juce::uint64 state)
+{
+    return (osEnabledRegisterState() & state) == state;
+}
+#endif
+
+bool cpuSupports(const KernelTable& table)
+{
+   #if DBASS_HAS_X86_KERNELS
+    const bool avx2 = juce::SystemStats::hasAVX() && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+
+    if (&table == &avx512Kernels)
+        return avx2 && juce::SystemStats::hasAVX512F() && osEnables(zmmState);
+    if (&table == &avx2Kernels)
+        return avx2 && osEnables(ymmState);
+   #endif
+
+    return &table == &baselineKernels;
+}
+
+const KernelTable* findTable(const juce::String& name)
+{
+   #if DBASS_HAS_X86_KERNELS
+    for (const auto* table : { &avx512Kernels, &avx2Kernels })
+        if (name == table->name)
+            return table;
+   #endif
+
+    return name == baselineKernels.name ? &baselineKernels : nullptr;
+}
+
+const KernelTable* detect()
+{
+    const auto requested = juce::SystemStats::getEnvironmentVariable("DBASS_KERNELS", {});
+    if (requested.isNotEmpty())
+    {
+        if (const auto* table = findTable(requested); table != nullptr && cpuSupports(*table))
+            return table;
+
+        juce::Logger::writeToLog("DBASS_KERNELS=" + requested + " is not available here, falling back to detection");
+    }
+
+   #if DBASS_HAS_X86_KERNELS
+    for (const auto* table : { &avx512Kernels, &avx2Kernels })
+        if (cpuSupports(*table))
+            return table;
+   #endif
+
+    return &baselineKernels;
+}
+
+std::atomic<const KernelTable*>& current()
+{
+    static std::atomic<const KernelTable*> table { detect() };
+    return table;
+}
+}
+
+const KernelTable& active()
+{
+    return *current().load(std::memory_order_relaxed);
+}
+
+bool force(const char* name)
+{
+    const auto* table = findTable(name);
+    if (table == nullptr || !cpuSupports(*table))
+        return false;
+
+    current().store(table, std::memory_order_relaxed);
+    return true;
+}
+}
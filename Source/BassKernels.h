@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+#ifndef DBASS_HAS_X86_KERNELS
+ #define DBASS_HAS_X86_KERNELS 0
+#endif
+
+// Vectorisable DSP passes used by AphexBassAudioProcessor::renderVoice.
+//
+// The same kernel source (BassKernelsImpl.h) is compiled once per instruction set and the best
+// table for the running CPU is picked on first use. Everything stateful (phase accumulators,
+// glide, the filter and bloom integrators) stays in the processor; the kernels only do the
+// element-wise work between those serial passes.
+namespace bass::kernels
+{
+#if defined(_MSC_VER)
+ #define DBASS_RESTRICT __restrict
+#else
+ #define DBASS_RESTRICT __restrict__
+#endif
+
+struct VoiceShapeArgs
+{
+    const float* mainPhase = nullptr;
+    const float* lfo = nullptr;
+    const float* sub = nullptr;
+    const float* noise = nullptr;
+    float* voice = nullptr;
+
+    float oscMix = 0.0f;
+    float subMix = 0.0f;
+    float fmAmt = 0.0f;
+    float fold = 0.0f;
+    float noiseLevel = 0.0f;
+    float driveGain = 1.0f;
+    float driveTrim = 1.0f;
+};
+
+struct FilterCoefficientArgs
+{
+    const float* filterEnv = nullptr;
+    const float* lfo = nullptr;
+    float* gL = nullptr;
+    float* hL = nullptr;
+    float* gR = nullptr;
+    float* hR = nullptr;
+
+    float cutoff = 220.0f;
+    float envAmount = 0.0f;
+    float lfoToCutoff = 0.0f;
+    float stereo = 0.0f;
+    float resonance = 0.5f;
+    float sampleRate = 44100.0f;
+};
+
+struct KernelTable
+{
+    const char* name;
+
+    // out = sin(phase), for any finite phase.
+    void (*sine)(const float* phase, float* out, int numSamples);
+
+    // Counter-based white noise in [-1, 1): sample i depends only on counter + i.
+    void (*noise)(std::uint32_t counter, float* out, int numSamples);
+
+    // Saw/pulse/sub mix, noise, wavefold and drive.
+    void (*shapeVoice)(const VoiceShapeArgs& args, int numSamples);
+
+    // Modulated cutoff for both channels, as TPT state-variable g and h coefficients.
+    void (*filterCoefficients)(const FilterCoefficientArgs& args, int numSamples);
+
+    // out = softClip(0.9 * (filtered + softClip(2.4 * bloom) * bloomAmount)) * gain
+    void (*outputStage)(const float* filtered, const float* bloom, float bloomAmount, float gain, float* out, int numSamples);
+};
+
+extern const KernelTable baselineKernels;
+#if DBASS_HAS_X86_KERNELS
+extern const KernelTable avx2Kernels;
+extern const KernelTable avx512Kernels;
+#endif
+
+// The table in use. Chosen once from the CPU features unless the DBASS_KERNELS environment
+// variable names another ("sse2" or "generic" for the baseline, "avx2", "avx512"), or force()
+// has been called.
+const KernelTable& active();
+
+// Switches to the named table for testing. Returns false, leaving the current table in place,
+// if that table wasn't built or the CPU can't run it.
+bool force(const char* name);
+}
@@ -0,0 +1,4 @@
+// AVX2 + FMA kernels. CMake compiles this file with the matching target flags.
+#define DBASS_KERNEL_NAME "avx2"
+#define DBASS_KERNEL_TABLE avx2Kernels
+#include "BassKernelsImpl.h"
@@ -0,0 +1,4 @@
+// AVX-512F kernels. CMake compiles this file with the matching target flags.
+#define DBASS_KERNEL_NAME "avx512"
+#define DBASS_KERNEL_TABLE avx512Kernels
+#include "BassKernelsImpl.h"
@@ -0,0 +1,8 @@
+// Baseline kernels, built with the project's default flags (SSE2 on x86-64).
+#if defined(__x86_64__) || defined(_M_X64)
+ #define DBASS_KERNEL_NAME "sse2"
+#else
+ #define DBASS_KERNEL_NAME "generic"
+#endif
+#define DBASS_KERNEL_TABLE baselineKernels
+#include "BassKernelsImpl.h"
@@ -0,0 +1,209 @@
+// Kernel bodies, included once per instruction set by the BassKernels*.cpp files.
+//
+// Each including file defines DBASS_KERNEL_TABLE and DBASS_KERNEL_NAME and is compiled with its
+// own target flags. Everything here has internal linkage and this file deliberately includes no
+// standard headers with inline templates (<algorithm>, <cmath>, JUCE), so the linker can never
+// fold an AVX-compiled inline function into the baseline path.
+//
+// The transcendental functions are polynomial approximations written without data-dependent
+// branches so the loops vectorise; their errors (~1e-7 for sine/exp2, under 1e-4 for tanh) are
+// far below audibility.
+
+#if !defined(DBASS_KERNEL_TABLE) || !defined(DBASS_KERNEL_NAME)
+ #error "Define DBASS_KERNEL_TABLE and DBASS_KERNEL_NAME before including BassKernelsImpl.h"
+#endif
+
+#include "BassKernels.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bass::kernels
+{
+namespace
+{
+constexpr float pi = 3.14159265358979f;
+constexpr float piHi = 3.140625f;
+constexpr float piLo = 9.67653589793e-4f;
+constexpr float invPi = 0.318309886183791f;
+constexpr float twoPi = 6.28318530717959f;
+constexpr float halfPi = 1.57079632679490f;
+
+inline float minf(float a, float b) { return a < b ? a : b; }
+inline float maxf(float a, float b) { return a > b ? a : b; }
+inline float clampf(float x, float lo, float hi) { return minf(maxf(x, lo), hi); }
+inline float lerpf(float amount, float from, float to) { return from + amount * (to - from); }
+
+inline std::int32_t floorToInt(float x)
+{
+    const auto truncated = static_cast<std::int32_t>(x);
+    return truncated - (x < static_cast<float>(truncated) ? 1 : 0);
+}
+
+inline float sineApprox(float x)
+{
+    // Reduce to r in [-pi/2, pi/2] with sin(x) = (-1)^k sin(r), then an odd degree-11 polynomial.
+    const std::int32_t k = floorToInt(x * invPi + 0.5f);
+    const float kf = static_cast<float>(k);
+    const float r = (x - kf * piHi) - kf * piLo;
+    const float r2 = r * r;
+
+    float p = -2.50521084e-8f;
+    p = p * r2 + 2.75573192e-6f;
+    p = p * r2 - 1.98412698e-4f;
+    p = p * r2 + 8.33333333e-3f;
+    p = p * r2 - 1.66666667e-1f;
+    const float s = r + r * r2 * p;
+
+    return (k & 1) != 0 ? -s : s;
+}
+
+inline float exp2Approx(float x)
+{
+    // 2^x = 2^i * 2^f with i = round(x) and f in [-0.5, 0.5].
+    x = clampf(x, -126.0f, 126.0f);
+    const std::int32_t i = floorToInt(x + 0.5f);
+    const float f = x - static_cast<float>(i);
+
+    float p = 1.54035304e-4f;
+    p = p * f + 1.33335581e-3f;
+    p = p * f + 9.61812911e-3f;
+    p = p * f + 5.55041087e-2f;
+    p = p * f + 2.40226507e-1f;
+    p = p * f + 6.93147181e-1f;
+    p = p * f + 1.0f;
+
+    const std::int32_t bits = (i + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+inline float tanhApprox(float x)
+{
+    // Pade (7,6). Within ~1e-6 for |x| < 3; the error grows towards the clamp and peaks at
+    // ~9.6e-5 just below |x| = 5. Saturates cleanly past it.
+    x = clampf(x, -5.0f, 5.0f);
+    const float x2 = x * x;
+    const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+    const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+    return clampf(num / den, -1.0f, 1.0f);
+}
+
+void sine(const float* DBASS_RESTRICT phase, float* DBASS_RESTRICT out, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        out[i] = sineApprox(phase[i]);
+}
+
+void noise(std::uint32_t counter, float* DBASS_RESTRICT out, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        std::uint32_t h = (counter + static_cast<std::uint32_t>(i)) * 0x9e3779b9u;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+
+        out[i] = static_cast<float>(static_cast<std::int32_t>(h >> 8)) * (2.0f / 16777216.0f) - 1.0f;
+    }
+}
+
+// The public entry points unpack their argument structs into restrict-qualified parameters here;
+// GCC ignores restrict on local pointers and would otherwise give up on alias checks.
+void shapeVoiceLoop(const float* DBASS_RESTRICT mainPhase, const float* DBASS_RESTRICT lfo,
+                    const float* DBASS_RESTRICT sub, const float* DBASS_RESTRICT noiseIn,
+                    float* DBASS_RESTRICT voice, const VoiceShapeArgs& args, int numSamples)
+{
+    const float oscMix = args.oscMix;
+    const float noiseLevel = args.noiseLevel;
+    const float driveGain = args.driveGain;
+    const float driveTrim = args.driveTrim;
+    const float mainLevel = 1.0f - args.subMix * 0.9f;
+    const float subLevel = args.subMix * 1.08f;
+    const float subDrive = 1.7f + args.subMix * 0.9f;
+    const float subBlend = 0.34f + args.subMix * 0.5f;
+    const float pulseDepth = 0.18f * (0.2f + args.fmAmt);
+    const float foldAmount = args.fold > 0.001f ? args.fold : 0.0f;
+    const float foldDrive = (1.0f + foldAmount * 4.0f) * halfPi;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float phaseNorm = mainPhase[i] * (1.0f / twoPi);
+        const float saw = (2.0f * phaseNorm) - 1.0f;
+        const float pulseWidth = clampf(0.49f + pulseDepth * lfo[i], 0.12f, 0.88f);
+        const float pulse = phaseNorm < pulseWidth ? 1.0f : -1.0f;
+        const float mainOsc = lerpf(oscMix, saw, pulse);
+
+        const float subSaturated = tanhApprox(sub[i] * subDrive);
+        const float subOsc = lerpf(subBlend, sub[i], subSaturated);
+
+        float v = mainOsc * mainLevel + subOsc * subLevel + noiseIn[i] * noiseLevel;
+        v = lerpf(foldAmount, v, sineApprox(v * foldDrive));
+        voice[i] = tanhApprox(v * driveGain) * driveTrim;
+    }
+}
+
+void filterCoefficientLoop(const float* DBASS_RESTRICT filterEnv, const float* DBASS_RESTRICT lfo,
+                           float* DBASS_RESTRICT gL, float* DBASS_RESTRICT hL,
+                           float* DBASS_RESTRICT gR, float* DBASS_RESTRICT hR,
+                           const FilterCoefficientArgs& args, int numSamples)
+{
+    const float cutoff = args.cutoff;
+    const float envAmount = args.envAmount;
+    const float lfoToCutoff = args.lfoToCutoff;
+    const float stereo = args.stereo;
+    const float r2 = 1.0f / args.resonance;
+    const float maxCutoff = minf(18000.0f, args.sampleRate * 0.49f);
+    const float radiansPerHz = pi / args.sampleRate;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float semis = envAmount * (filterEnv[i] - 0.2f) * 72.0f + lfo[i] * lfoToCutoff * 36.0f;
+        const float cutoffL = clampf(cutoff * exp2Approx(semis * (1.0f / 12.0f)), 20.0f, maxCutoff);
+        const float cutoffR = clampf(cutoffL * exp2Approx(stereo * lfo[i] * (4.0f / 12.0f)), 20.0f, maxCutoff);
+
+        const float wL = cutoffL * radiansPerHz;
+        const float wR = cutoffR * radiansPerHz;
+        const float tanL = sineApprox(wL) / sineApprox(wL + halfPi);
+        const float tanR = sineApprox(wR) / sineApprox(wR + halfPi);
+
+        gL[i] = tanL;
+        gR[i] = tanR;
+        hL[i] = 1.0f / (1.0f + r2 * tanL + tanL * tanL);
+        hR[i] = 1.0f / (1.0f + r2 * tanR + tanR * tanR);
+    }
+}
+
+void shapeVoice(const VoiceShapeArgs& args, int numSamples)
+{
+    shapeVoiceLoop(args.mainPhase, args.lfo, args.sub, args.noise, args.voice, args, numSamples);
+}
+
+void filterCoefficients(const FilterCoefficientArgs& args, int numSamples)
+{
+    filterCoefficientLoop(args.filterEnv, args.lfo, args.gL, args.hL, args.gR, args.hR, args, numSamples);
+}
+
+void outputStage(const float* DBASS_RESTRICT filtered, const float* DBASS_RESTRICT bloom, float bloomAmount, float gain,
+                 float* DBASS_RESTRICT out, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float withBloom = filtered[i] + tanhApprox(bloom[i] * 2.4f) * bloomAmount;
+        out[i] = tanhApprox(withBloom * 0.9f) * gain;
+    }
+}
+}
+
+const KernelTable DBASS_KERNEL_TABLE {
+    DBASS_KERNEL_NAME,
+    sine,
+    noise,
+    shapeVoice,
+    filterCoefficients,
+    outputStage
+};
+}
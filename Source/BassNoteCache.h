@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "BassPresets.h"
+
+struct NoteCacheStats
+{
+    juce::uint64 hits = 0;
+    juce::uint64 misses = 0;
+    juce::uint64 samplesServed = 0;
+    juce::uint64 evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// Memoised onset segments of notes that start from silence, for offline renders.
+//
+// A note that starts from an idle voice with its state retriggered depends only on the parameter
+// values, note, velocity and render format, so its output up to the next MIDI event or parameter
+// change can be recorded once and copied out on every repeat. Alongside the samples each entry keeps
+// a snapshot of the voice state every snapshotInterval samples and the state at its end, so the
+// processor can hand over to live rendering at any point with at most one interval of catch-up.
+//
+// Entries grow on the audio thread, so this is only meant for non-realtime rendering. The total
+// footprint stays under the byte budget by evicting the least recently used entries.
+template <typename VoiceState>
+class NoteRenderCache
+{
+public:
+    static constexpr int snapshotInterval = 256;
+    static constexpr int maxChannels = 2;
+    static constexpr double maxEntrySeconds = 2.0;
+
+    struct Key
+    {
+        std::array<float, bass::parameterIds.size()> parameters {};
+        int note = 0;
+        float velocity = 0.0f;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        const void* kernels = nullptr;
+
+        // Compared bit for bit, so a key never matches a render it would not reproduce exactly.
+        bool sameRender(const Key& other) const
+        {
+            return std::memcmp(parameters.data(), other.parameters.data(), sizeof(float) * parameters.size()) == 0
+                && std::memcmp(&sampleRate, &other.sampleRate, sizeof(sampleRate)) == 0
+                && numChannels == other.numChannels && kernels == other.kernels;
+        }
+
+        bool operator==(const Key& other) const
+        {
+            return sameRender(other) && note == other.note
+                && std::memcmp(&velocity, &other.velocity, sizeof(velocity)) == 0;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        juce::uint64 hash = 0;
+        std::array<std::vector<float>, maxChannels> samples;
+        std::vector<VoiceState> snapshots; // snapshots[i] is the state at sample i * snapshotInterval.
+        VoiceState endState;               // State after the last recorded sample.
+        int length = 0;
+        bool sealed = false;               // No further samples will be appended.
+        juce::uint64 lastUse = 0;
+        size_t bytes = 0;
+    };
+
+    void setBudget(size_t newBudgetBytes)
+    {
+        budget = newBudgetBytes;
+        evictUntilFits(0, nullptr);
+    }
+
+    bool isEnabled() const { return budget > 0; }
+
+    NoteCacheStats getStats() const
+    {
+        auto result = stats;
+        result.entries = entries.size();
+        result.bytes = bytesUsed;
+        return result;
+    }
+
+    // Returns the entry for this onset, or null. Counts a hit or miss.
+    Entry* find(const Key& key)
+    {
+        const auto hash = hashOf(key);
+        for (auto& entry : entries)
+        {
+            if (entry->hash == hash && entry->key == key)
+            {
+                entry->lastUse = ++useClock;
+                ++stats.hits;
+                return entry.get();
+            }
+        }
+
+        ++stats.misses;
+        return nullptr;
+    }
+
+    // Starts a new entry whose first snapshot is the onset state, or returns null if it can't fit.
+    Entry* create(const Key& key, const VoiceState& onset)
+    {
+        const size_t baseBytes = sizeof(Entry) + sizeof(VoiceState);
+        if (!evictUntilFits(baseBytes, nullptr))
+            return nullptr;
+
+        auto entry = std::make_unique<Entry>();
+        entry->key = key;
+        entry->hash = hashOf(key);
+        entry->snapshots.push_back(onset);
+        entry->endState = onset;
+        entry->lastUse = ++useClock;
+        entry->bytes = baseBytes;
+        bytesUsed += baseBytes;
+
+        entries.push_back(std::move(entry));
+        return entries.back().get();
+    }
+
+    // Largest number of samples the entry may still grow by, evicting other entries to make room.
+    int reserve(Entry& entry, int numSamples, double sampleRate)
+    {
+        const int maxLength = juce::roundToInt(maxEntrySeconds * sampleRate);
+        numSamples = juce::jmin(numSamples, maxLength - entry.length);
+        if (entry.sealed || numSamples <= 0)
+            return 0;
+
+        const auto newLength = static_cast<size_t>(entry.length + numSamples);
+        const size_t needed = growthBytes(entry.samples[0], newLength) * static_cast<size_t>(entry.key.numChannels)
+                            + growthBytes(entry.snapshots, newLength / snapshotInterval + 1);
+        return evictUntilFits(needed, &entry) ? numSamples : 0;
+    }
+
+    // Only call with a count reserve() allowed; snapshots are added at each interval boundary.
+    void append(Entry& entry, const float* const* channels, int numSamples)
+    {
+        const auto newLength = static_cast<size_t>(entry.length + numSamples);
+        for (int ch = 0; ch < entry.key.numChannels; ++ch)
+        {
+            auto& lane = entry.samples[static_cast<size_t>(ch)];
+            account(entry, grow(lane, newLength));
+            lane.insert(lane.end(), channels[ch], channels[ch] + numSamples);
+        }
+
+        entry.length += numSamples;
+    }
+
+    void addSnapshot(Entry& entry, const VoiceState& state)
+    {
+        account(entry, grow(entry.snapshots, entry.snapshots.size() + 1));
+        entry.snapshots.push_back(state);
+    }
+
+    void countServed(int numSamples) { stats.samplesServed += static_cast<juce::uint64>(numSamples); }
+
+private:
+    static juce::uint64 hashOf(const Key& key)
+    {
+        // FNV-1a over the same bytes the key compares.
+        juce::uint64 hash = 14695981039346656037ull;
+        const auto mix = [&hash](const void* data, size_t size)
+        {
+            const auto* bytes = static_cast<const juce::uint8*>(data);
+            for (size_t i = 0; i < size; ++i)
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+        };
+
+        mix(key.parameters.data(), sizeof(float) * key.parameters.size());
+        mix(&key.note, sizeof(key.note));
+        mix(&key.velocity, sizeof(key.velocity));
+        mix(&key.sampleRate, sizeof(key.sampleRate));
+        mix(&key.numChannels, sizeof(key.numChannels));
+        mix(&key.kernels, sizeof(key.kernels));
+        return hash;
+    }
+
+    // Vectors grow by half their capacity; the budget is charged for capacity, not size.
+    template <typename T>
+    static size_t grownCapacity(const std::vector<T>& v, size_t newSize)
+    {
+        return newSize <= v.capacity() ? v.capacity() : std::max(newSize, v.capacity() + v.capacity() / 2);
+    }
+
+    template <typename T>
+    static size_t growthBytes(const std::vector<T>& v, size_t newSize)
+    {
+        return sizeof(T) * (grownCapacity(v, newSize) - v.capacity());
+    }
+
+    template <typename T>
+    static size_t grow(std::vector<T>& v, size_t newSize)
+    {
+        const size_t bytes = growthBytes(v, newSize);
+        v.reserve(grownCapacity(v, newSize));
+        return bytes;
+    }
+
+    void account(Entry& entry, size_t bytes)
+    {
+        entry.bytes += bytes;
+        bytesUsed += bytes;
+    }
+
+    // Evicts least recently used entries other than keep until extraBytes more would fit.
+    bool evictUntilFits(size_t extraBytes, const Entry* keep)
+    {
+        while (bytesUsed + extraBytes > budget)
+        {
+            auto victim = entries.end();
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+                if (it->get() != keep && (victim == entries.end() || (*it)->lastUse < (*victim)->lastUse))
+                    victim = it;
+
+            if (victim == entries.end())
+                return false;
+
+            bytesUsed -= (*victim)->bytes;
+            entries.erase(victim);
+            ++stats.evictions;
+        }
+
+        return true;
+    }
+
+    std::vector<std::unique_ptr<Entry>> entries;
+    size_t budget = 0;
+    size_t bytesUsed = 0;
+    juce::uint64 useClock = 0;
+    NoteCacheStats stats;
+};
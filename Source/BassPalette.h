@@ -0,0 +1,12 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+
+// Phosphor colours shared by the editor and the telemetry view.
+namespace bass::palette
+{
+inline const juce::Colour panel { 0xff050a03 };
+inline const juce::Colour phosphor { 0xff8dff67 };
+inline const juce::Colour phosphorHot { 0xffb9ff9e };
+inline const juce::Colour phosphorDim { 0xff4a9535 };
+}
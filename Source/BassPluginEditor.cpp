@@ -1,19 +1,16 @@
 #include "BassPluginEditor.h"
+#include "BassPalette.h"
+#include "BassPresets.h"
 
 namespace
 {
+using namespace bass::palette;
+
 const juce::Colour bg { 0xff020401 };
-const juce::Colour panel { 0xff050a03 };
-const juce::Colour phosphor { 0xff8dff67 };
-const juce::Colour phosphorHot { 0xffb9ff9e };
-const juce::Colour phosphorDim { 0xff4a9535 };
 const juce::Colour textMain { 0xffc9ffb8 };
 
-constexpr std::array<const char*, 22> parameterIds {
-    "output", "tune", "glide", "oscMix", "sub", "fmAmt", "fmRatio", "fold", "drive", "noise",
-    "cutoff", "resonance", "envAmt", "lfoRate", "lfoToCutoff", "stereo", "attack", "decay", "sustain", "release",
-    "monoLegato", "accent"
-};
+constexpr int telemetryHeight = 120;
+constexpr int telemetryGap = 6;
 
 constexpr std::array<const char*, 22> sliderNames {
     "Output", "Tune", "Glide", "Osc", "Sub", "FM Amt", "FM Ratio", "Fold", "Drive", "Noise",
@@ -21,54 +18,8 @@ constexpr std::array<const char*, 22> sliderNames {
     "Legato", "Accent"
 };
 
-struct PresetData
-{
-    const char* name = "";
-    std::array<float, 22> values {};
-};
-
-constexpr std::array<PresetData, 10> presets {{
-    {
-        "drukqs metallic sub",
-        { -9.2f, 0.0f, 0.020f, 0.84f, 0.74f, 0.42f, 2.75f, 0.50f, 0.56f, 0.03f, 235.0f, 0.62f, 0.76f, 3.2f, 0.20f, 0.18f, 0.002f, 0.14f, 0.58f, 0.18f, 1.0f, 0.66f }
-    },
-    {
-        "syro rubber bass",
-        { -10.3f, -12.0f, 0.065f, 0.34f, 0.86f, 0.22f, 1.35f, 0.22f, 0.46f, 0.06f, 170.0f, 0.34f, 0.68f, 1.1f, 0.16f, 0.12f, 0.006f, 0.22f, 0.72f, 0.30f, 1.0f, 0.45f }
-    },
-    {
-        "ventolin broken acid bass",
-        { -11.8f, 7.0f, 0.012f, 0.70f, 0.35f, 0.76f, 4.40f, 0.72f, 0.78f, 0.10f, 410.0f, 0.84f, 0.92f, 6.8f, 0.54f, 0.34f, 0.001f, 0.11f, 0.36f, 0.15f, 0.0f, 0.92f }
-    },
-    {
-        "sub trench pressure",
-        { -8.0f, -12.0f, 0.050f, 0.18f, 0.96f, 0.12f, 0.70f, 0.12f, 0.58f, 0.01f, 120.0f, 0.22f, 0.74f, 0.34f, 0.08f, 0.05f, 0.003f, 0.24f, 0.84f, 0.46f, 1.0f, 0.38f }
-    },
-    {
-        "hollow fm weight",
-        { -9.8f, -7.0f, 0.032f, 0.62f, 0.78f, 0.56f, 3.30f, 0.40f, 0.60f, 0.04f, 210.0f, 0.44f, 0.70f, 2.2f, 0.22f, 0.14f, 0.002f, 0.16f, 0.66f, 0.24f, 1.0f, 0.62f }
-    },
-    {
-        "glass growl mono",
-        { -12.5f, 0.0f, 0.016f, 0.86f, 0.52f, 0.68f, 5.20f, 0.78f, 0.84f, 0.08f, 360.0f, 0.72f, 0.88f, 5.4f, 0.40f, 0.20f, 0.001f, 0.12f, 0.40f, 0.12f, 1.0f, 0.88f }
-    },
-    {
-        "detuned slab",
-        { -8.8f, -5.0f, 0.040f, 0.40f, 0.90f, 0.18f, 1.02f, 0.20f, 0.62f, 0.03f, 160.0f, 0.30f, 0.76f, 0.62f, 0.12f, 0.36f, 0.006f, 0.26f, 0.80f, 0.40f, 1.0f, 0.34f }
-    },
-    {
-        "wide broken roller",
-        { -10.6f, 0.0f, 0.030f, 0.66f, 0.68f, 0.50f, 2.90f, 0.48f, 0.70f, 0.09f, 300.0f, 0.64f, 0.82f, 4.6f, 0.34f, 0.72f, 0.001f, 0.10f, 0.44f, 0.16f, 0.0f, 0.74f }
-    },
-    {
-        "clean 2step foundation",
-        { -9.0f, -12.0f, 0.070f, 0.24f, 0.92f, 0.08f, 0.60f, 0.08f, 0.30f, 0.02f, 130.0f, 0.18f, 0.52f, 0.26f, 0.05f, 0.08f, 0.005f, 0.20f, 0.86f, 0.52f, 1.0f, 0.24f }
-    },
-    {
-        "acid melt stomp",
-        { -11.4f, 12.0f, 0.010f, 0.76f, 0.44f, 0.72f, 4.80f, 0.74f, 0.86f, 0.11f, 480.0f, 0.88f, 0.96f, 7.2f, 0.58f, 0.24f, 0.001f, 0.09f, 0.32f, 0.11f, 0.0f, 0.94f }
-    }
-}};
+using bass::parameterIds;
+using bass::presets;
 }
 
 AphexBassAudioProcessorEditor::LookAndFeel::LookAndFeel()
@@ -77,10 +28,10 @@ AphexBassAudioProcessorEditor::LookAndFeel::LookAndFeel()
 }
 
 AphexBassAudioProcessorEditor::AphexBassAudioProcessorEditor(AphexBassAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), telemetryView(p.getTelemetry())
 {
     setLookAndFeel(&lookAndFeel);
-    setSize(1080, 430);
+    setSize(1080, 430 + telemetryHeight + telemetryGap);
 
     titleLabel.setText("D-BASS", juce::dontSendNotification);
     titleLabel.setColour(juce::Label::textColourId, phosphorHot);
@@ -113,6 +64,7 @@ AphexBassAudioProcessorEditor::AphexBassAudioProcessorEditor(AphexBassAudioProce
             applyPreset(selected - 1);
     };
     addAndMakeVisible(presetBox);
+    addAndMakeVisible(telemetryView);
 
     auto& apvts = audioProcessor.getAPVTS();
 
@@ -194,6 +146,7 @@ void AphexBassAudioProcessorEditor::paint(juce::Graphics& g)
 
     auto content = getLocalBounds().reduced(14);
     content.removeFromTop(54);
+    content.removeFromBottom(telemetryHeight + telemetryGap);
     const int columns = 11;
     const int rows = 2;
     const int cellGap = 5;
@@ -246,6 +199,8 @@ void AphexBassAudioProcessorEditor::resized()
     presetBox.setBounds(header.removeFromLeft(320).reduced(0, 4));
 
     bounds.removeFromTop(6);
+    telemetryView.setBounds(bounds.removeFromBottom(telemetryHeight));
+    bounds.removeFromBottom(telemetryGap);
 
     const int columns = 11;
     const int rows = 2;
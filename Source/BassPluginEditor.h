@@ -6,6 +6,7 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 
 #include "BassPluginProcessor.h"
+#include "BassTelemetryView.h"
 
 class AphexBassAudioProcessorEditor final : public juce::AudioProcessorEditor
 {
@@ -39,6 +40,7 @@ private:
     juce::Label infoLabel;
     juce::Label presetLabel;
     juce::ComboBox presetBox;
+    BassTelemetryView telemetryView;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AphexBassAudioProcessorEditor)
 };
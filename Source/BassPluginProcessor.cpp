@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <utility>
 
 namespace
 {
@@ -52,6 +53,12 @@ AphexBassAudioProcessor::AphexBassAudioProcessor()
     releaseParam = parameters.getRawParameterValue("release");
     monoLegatoParam = parameters.getRawParameterValue("monoLegato");
     accentParam = parameters.getRawParameterValue("accent");
+
+    for (size_t i = 0; i < bass::parameterIds.size(); ++i)
+        cacheKeyParams[i] = parameters.getRawParameterValue(bass::parameterIds[i]);
+
+    scratch.resize(512);
+    cacheScratch.setSize(NoteCache::maxChannels, NoteCache::snapshotInterval);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout AphexBassAudioProcessor::createParameterLayout()
@@ -92,36 +99,48 @@ void AphexBassAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
 {
     juce::ignoreUnused(samplesPerBlock);
 
+    // Close out any cached note while its state still belongs to the old format.
+    leaveCachedNote();
+
     currentSampleRate = juce::jmax(8000.0, sampleRate);
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = currentSampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(juce::jmax(64, samplesPerBlock));
-    spec.numChannels = 1;
+    scratch.resize(static_cast<size_t>(juce::jmax(64, samplesPerBlock)));
+    telemetry.prepare(currentSampleRate);
+
+    ampEnv.setSampleRate(currentSampleRate);
+    filterEnv.setSampleRate(currentSampleRate);
+
+    reset();
+}
+
+void AphexBassAudioProcessor::releaseResources()
+{
+}
+
+void AphexBassAudioProcessor::reset()
+{
+    // A partly recorded entry keeps what it has; the state it ends in is still the live one here.
+    if (cacheMode == CacheMode::recording)
+        leaveCachedNote();
+    cacheMode = CacheMode::off;
+    cacheEntry = nullptr;
+    pendingOnsetNote = -1;
 
-    filterL.prepare(spec);
-    filterR.prepare(spec);
-    filterL.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    filterR.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    filterL.reset();
-    filterR.reset();
+    filterStateL = {};
+    filterStateR = {};
+    noiseCounter = 0;
 
     ampEnv.reset();
     filterEnv.reset();
-    ampEnv.setSampleRate(currentSampleRate);
-    filterEnv.setSampleRate(currentSampleRate);
 
     phaseMain = phaseSub = phaseFm = lfoPhase = 0.0f;
     currentFrequency = targetFrequency = 55.0f;
+    lastVelocity = 1.0f;
     bassBloomStateL = 0.0f;
     bassBloomStateR = 0.0f;
     heldNotes.clear();
 }
 
-void AphexBassAudioProcessor::releaseResources()
-{
-}
-
 bool AphexBassAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
     return layouts.getMainOutputChannelSet() == juce::AudioChannelSet::mono()
@@ -144,6 +163,20 @@ void AphexBassAudioProcessor::noteOn(int midiNote, float velocity)
     if (!ampEnv.isActive())
     {
         currentFrequency = targetFrequency;
+
+        if (lfoRetrigger)
+        {
+            // Start from a clean voice, so the note depends only on its pitch, velocity and the patch.
+            phaseMain = phaseSub = phaseFm = lfoPhase = 0.0f;
+            noiseCounter = 0;
+            filterStateL = {};
+            filterStateR = {};
+            bassBloomStateL = 0.0f;
+            bassBloomStateR = 0.0f;
+            filterEnv.reset();
+            pendingOnsetNote = midiNote;
+        }
+
         ampEnv.noteOn();
         filterEnv.noteOn();
         return;
@@ -180,19 +213,18 @@ void AphexBassAudioProcessor::retargetFrequencyFromHeldNotes()
     targetFrequency = midiNoteToHz(activeNote) * std::pow(2.0f, tuneSemi / 12.0f);
 }
 
-float AphexBassAudioProcessor::softClip(float x)
+void AphexBassAudioProcessor::handleMidiMessage(const juce::MidiMessage& message)
 {
-    return std::tanh(x);
-}
-
-float AphexBassAudioProcessor::waveFold(float x, float amount)
-{
-    if (amount <= 0.001f)
-        return x;
-
-    const float drive = 1.0f + amount * 4.0f;
-    const float folded = std::sin(x * drive * juce::MathConstants<float>::halfPi);
-    return juce::jmap(amount, x, folded);
+    if (message.isNoteOn())
+        noteOn(message.getNoteNumber(), message.getFloatVelocity());
+    else if (message.isNoteOff())
+        noteOff(message.getNoteNumber());
+    else if (message.isAllNotesOff() || message.isAllSoundOff())
+    {
+        heldNotes.clear();
+        ampEnv.noteOff();
+        filterEnv.noteOff();
+    }
 }
 
 void AphexBassAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
@@ -202,142 +234,406 @@ void AphexBassAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
 
-    ampEnvParams.attack = readParam(attackParam, 0.003f);
-    ampEnvParams.decay = readParam(decayParam, 0.18f);
-    ampEnvParams.sustain = readParam(sustainParam, 0.66f);
-    ampEnvParams.release = readParam(releaseParam, 0.21f);
-    ampEnv.setParameters(ampEnvParams);
+    const bool cacheAllowed = noteCacheAllowed(numChannels);
+    NoteCache::Key cacheKey;
+    if (cacheAllowed)
+        cacheKey = makeCacheKey(numChannels);
 
-    filterEnvParams.attack = ampEnvParams.attack * 0.3f;
-    filterEnvParams.decay = juce::jmax(0.03f, ampEnvParams.decay * 0.6f);
-    filterEnvParams.sustain = juce::jlimit(0.0f, 1.0f, ampEnvParams.sustain * 0.75f);
-    filterEnvParams.release = juce::jmax(0.02f, ampEnvParams.release * 0.7f);
-    filterEnv.setParameters(filterEnvParams);
+    // A cached note whose patch or format no longer matches goes back to live rendering before
+    // anything below reads the voice.
+    if (cacheMode != CacheMode::off && (!cacheAllowed || !cacheKey.sameRender(cacheEntry->key)))
+        leaveCachedNote();
 
+    BassEnvelope::Parameters newAmpEnvParams;
+    newAmpEnvParams.attack = readParam(attackParam, 0.003f);
+    newAmpEnvParams.decay = readParam(decayParam, 0.18f);
+    newAmpEnvParams.sustain = readParam(sustainParam, 0.66f);
+    newAmpEnvParams.release = readParam(releaseParam, 0.21f);
+
+    // The filter envelope follows the amp envelope's settings; only re-derive it when they move.
+    if (!(newAmpEnvParams == ampEnvParams))
+    {
+        ampEnvParams = newAmpEnvParams;
+        filterEnvParams.attack = ampEnvParams.attack * 0.3f;
+        filterEnvParams.decay = juce::jmax(0.03f, ampEnvParams.decay * 0.6f);
+        filterEnvParams.sustain = juce::jlimit(0.0f, 1.0f, ampEnvParams.sustain * 0.75f);
+        filterEnvParams.release = juce::jmax(0.02f, ampEnvParams.release * 0.7f);
+
+        ampEnv.setParameters(ampEnvParams);
+        filterEnv.setParameters(filterEnvParams);
+    }
+
+    BlockParameters block;
+    block.oscMix = readParam(oscMixParam, 0.72f);
+    block.subMix = readParam(subParam, 0.62f);
+    block.fmAmt = readParam(fmAmtParam, 0.28f);
+    block.fmRatio = readParam(fmRatioParam, 2.0f);
+    block.fold = readParam(foldParam, 0.36f);
+    block.drive = readParam(driveParam, 0.45f);
+    block.noise = readParam(noiseParam, 0.07f);
+    block.cutoff = readParam(cutoffParam, 220.0f);
+    block.resonance = readParam(resonanceParam, 0.28f);
+    block.envAmt = readParam(envAmtParam, 0.72f);
+    block.lfoToCutoff = readParam(lfoToCutoffParam, 0.22f);
+    block.stereo = readParam(stereoParam, 0.25f);
+    block.accent = readParam(accentParam, 0.5f);
+    block.outputGain = juce::Decibels::decibelsToGain(readParam(outputParam, -8.0f));
+
+    block.sampleRate = static_cast<float>(currentSampleRate);
+    block.glideCoeff = expSlewCoefficient(readParam(glideParam, 0.025f), block.sampleRate);
+    block.lfoIncrement = twoPi * readParam(lfoRateParam, 2.8f) / block.sampleRate;
+
+    buffer.clear();
+
+    // Render up to each MIDI event before applying it, so retriggers land on their exact sample.
+    int position = 0;
     for (const auto metadata : midiMessages)
     {
+        const int eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+        renderSegment(buffer, position, eventPosition, block);
+        position = eventPosition;
+
+        // Any note event makes the rest of a cached note depend on history (glide, legato, overlap).
         const auto message = metadata.getMessage();
-        if (message.isNoteOn())
-            noteOn(message.getNoteNumber(), message.getFloatVelocity());
-        else if (message.isNoteOff())
-            noteOff(message.getNoteNumber());
-        else if (message.isAllNotesOff() || message.isAllSoundOff())
+        if (cacheMode != CacheMode::off
+            && (message.isNoteOnOrOff() || message.isAllNotesOff() || message.isAllSoundOff()))
+            leaveCachedNote();
+
+        handleMidiMessage(message);
+
+        if (pendingOnsetNote >= 0)
         {
-            heldNotes.clear();
-            ampEnv.noteOff();
-            filterEnv.noteOff();
+            if (cacheAllowed)
+                beginCachedNote(cacheKey, block);
+            pendingOnsetNote = -1;
         }
     }
 
+    renderSegment(buffer, position, numSamples, block);
     midiMessages.clear();
-    buffer.clear();
+}
 
-    const float oscMix = readParam(oscMixParam, 0.72f);
-    const float subMix = readParam(subParam, 0.62f);
-    const float fmAmt = readParam(fmAmtParam, 0.28f);
-    const float fmRatio = readParam(fmRatioParam, 2.0f);
-    const float fold = readParam(foldParam, 0.36f);
-    const float drive = readParam(driveParam, 0.45f);
-    const float noise = readParam(noiseParam, 0.07f);
-    const float cutoff = readParam(cutoffParam, 220.0f);
-    const float resonance = readParam(resonanceParam, 0.28f);
-    const float envAmt = readParam(envAmtParam, 0.72f);
-    const float lfoRate = readParam(lfoRateParam, 2.8f);
-    const float lfoToCutoff = readParam(lfoToCutoffParam, 0.22f);
-    const float stereo = readParam(stereoParam, 0.25f);
-    const float outputDb = readParam(outputParam, -8.0f);
-    const float accent = readParam(accentParam, 0.5f);
-    const float outputGain = juce::Decibels::decibelsToGain(outputDb);
-
-    const float sampleRate = static_cast<float>(currentSampleRate);
-    const float glideTime = readParam(glideParam, 0.025f);
-    const float glideCoeff = expSlewCoefficient(glideTime, sampleRate);
-
-    const float lfoIncrement = twoPi * lfoRate / sampleRate;
-    const float accentVelocity = juce::jlimit(0.0f, 1.0f, (lastVelocity - 0.55f) * 2.2f);
-    const float accentBoost = accent * accentVelocity;
-    const float driveGain = 1.0f + 15.0f * drive * (1.0f + 0.5f * accentBoost);
-    const float driveTrim = 1.0f / std::sqrt(juce::jmax(1.0f, driveGain));
+void AphexBassAudioProcessor::setNoteCacheSize(size_t bytes)
+{
+    leaveCachedNote();
+    noteCache.setBudget(bytes);
+}
+
+bool AphexBassAudioProcessor::noteCacheAllowed(int numChannels) const
+{
+    return lfoRetrigger && isNonRealtime() && noteCache.isEnabled()
+        && numChannels > 0 && numChannels <= NoteCache::maxChannels;
+}
+
+AphexBassAudioProcessor::NoteCache::Key AphexBassAudioProcessor::makeCacheKey(int numChannels) const
+{
+    NoteCache::Key key;
+    for (size_t i = 0; i < cacheKeyParams.size(); ++i)
+        key.parameters[i] = readParam(cacheKeyParams[i], 0.0f);
+
+    key.sampleRate = currentSampleRate;
+    key.numChannels = numChannels;
+    key.kernels = &bass::kernels::active();
+    return key;
+}
+
+AphexBassAudioProcessor::VoiceState AphexBassAudioProcessor::captureVoiceState() const
+{
+    VoiceState state;
+    state.ampEnv = ampEnv;
+    state.filterEnv = filterEnv;
+    state.filterL = filterStateL;
+    state.filterR = filterStateR;
+    state.phaseMain = phaseMain;
+    state.phaseSub = phaseSub;
+    state.phaseFm = phaseFm;
+    state.lfoPhase = lfoPhase;
+    state.currentFrequency = currentFrequency;
+    state.bloomL = bassBloomStateL;
+    state.bloomR = bassBloomStateR;
+    state.noiseCounter = noiseCounter;
+    return state;
+}
+
+void AphexBassAudioProcessor::restoreVoiceState(const VoiceState& state)
+{
+    ampEnv = state.ampEnv;
+    filterEnv = state.filterEnv;
+    filterStateL = state.filterL;
+    filterStateR = state.filterR;
+    phaseMain = state.phaseMain;
+    phaseSub = state.phaseSub;
+    phaseFm = state.phaseFm;
+    lfoPhase = state.lfoPhase;
+    currentFrequency = state.currentFrequency;
+    bassBloomStateL = state.bloomL;
+    bassBloomStateR = state.bloomR;
+    noiseCounter = state.noiseCounter;
+}
+
+void AphexBassAudioProcessor::beginCachedNote(NoteCache::Key key, const BlockParameters& block)
+{
+    key.note = pendingOnsetNote;
+    key.velocity = lastVelocity;
+
+    cacheBlock = block;
+    cacheTargetFrequency = targetFrequency;
+    cachePosition = 0;
+
+    if ((cacheEntry = noteCache.find(key)) != nullptr)
+    {
+        cacheMode = CacheMode::replaying;
+        return;
+    }
+
+    cacheEntry = noteCache.create(key, captureVoiceState());
+    cacheMode = cacheEntry != nullptr ? CacheMode::recording : CacheMode::off;
+}
+
+void AphexBassAudioProcessor::leaveCachedNote()
+{
+    if (cacheMode == CacheMode::recording)
+    {
+        cacheEntry->endState = captureVoiceState();
+    }
+    else if (cacheMode == CacheMode::replaying)
+    {
+        // The live voice hasn't moved since the onset. Pick it up from the nearest snapshot and
+        // render the few samples since then without output, with the pitch the note was recorded at;
+        // a state load may already have retargeted the live one.
+        restoreVoiceState(cacheEntry->snapshots[static_cast<size_t>(cachePosition / NoteCache::snapshotInterval)]);
+
+        if (const int catchUp = cachePosition % NoteCache::snapshotInterval; catchUp > 0)
+        {
+            const float liveTarget = std::exchange(targetFrequency, cacheTargetFrequency);
+            renderVoice(cacheScratch, 0, catchUp, cacheBlock, false);
+            targetFrequency = liveTarget;
+        }
+    }
+
+    cacheMode = CacheMode::off;
+    cacheEntry = nullptr;
+}
+
+void AphexBassAudioProcessor::renderSegment(juce::AudioBuffer<float>& buffer, int startSample, int endSample,
+                                            const BlockParameters& block)
+{
+    while (startSample < endSample)
+    {
+        if (cacheMode == CacheMode::off)
+        {
+            renderVoice(buffer, startSample, endSample, block);
+            return;
+        }
+
+        if (cacheMode == CacheMode::replaying)
+        {
+            const int available = cacheEntry->length - cachePosition;
+            if (available == 0)
+            {
+                // Past the recorded part: continue live from the end state, recording if there's room.
+                restoreVoiceState(cacheEntry->endState);
+                if (cacheEntry->sealed)
+                {
+                    cacheMode = CacheMode::off;
+                    cacheEntry = nullptr;
+                }
+                else
+                {
+                    cacheMode = CacheMode::recording;
+                }
+                continue;
+            }
+
+            const int count = juce::jmin(available, endSample - startSample);
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.copyFrom(ch, startSample, cacheEntry->samples[static_cast<size_t>(ch)].data() + cachePosition, count);
+
+            noteCache.countServed(count);
+            cachePosition += count;
+            startSample += count;
+            continue;
+        }
+
+        // Recording stops at each snapshot boundary so the state there can be captured.
+        const int untilSnapshot = NoteCache::snapshotInterval - cachePosition % NoteCache::snapshotInterval;
+        const int count = noteCache.reserve(*cacheEntry, juce::jmin(endSample - startSample, untilSnapshot), currentSampleRate);
+        if (count == 0)
+        {
+            // Length cap or memory budget reached; the entry ends here for good.
+            cacheEntry->endState = captureVoiceState();
+            cacheEntry->sealed = true;
+            cacheMode = CacheMode::off;
+            cacheEntry = nullptr;
+            continue;
+        }
+
+        renderVoice(buffer, startSample, startSample + count, block);
+
+        std::array<const float*, NoteCache::maxChannels> channels {};
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            channels[static_cast<size_t>(ch)] = buffer.getReadPointer(ch, startSample);
+        noteCache.append(*cacheEntry, channels.data(), count);
+
+        cachePosition += count;
+        startSample += count;
+
+        if (cachePosition % NoteCache::snapshotInterval == 0)
+            noteCache.addSnapshot(*cacheEntry, captureVoiceState());
+    }
+}
 
-    juce::Random random;
+void AphexBassAudioProcessor::VoiceScratch::resize(size_t numSamples)
+{
+    for (auto* lane : { &ampEnv, &filterEnv, &lfoPhase, &lfo, &fmPhase, &fm, &subPhase, &sub, &mainPhase,
+                        &noise, &voice, &gL, &hL, &gR, &hR, &left, &right, &bloomL, &bloomR })
+        lane->assign(numSamples, 0.0f);
+}
+
+float AphexBassAudioProcessor::processFilterSample(FilterState& state, float input, float g, float h, float r2)
+{
+    // Lowpass output of the TPT state-variable filter (same topology as juce::dsp::StateVariableTPTFilter).
+    const float yHP = h * (input - state.s1 * (g + r2) - state.s2);
+    const float yBP = yHP * g + state.s1;
+    state.s1 = yHP * g + yBP;
+    const float yLP = yBP * g + state.s2;
+    state.s2 = yBP * g + yLP;
+    return yLP;
+}
+
+void AphexBassAudioProcessor::renderVoice(juce::AudioBuffer<float>& buffer, int startSample, int endSample, const BlockParameters& block,
+                                          bool feedTelemetry)
+{
+    const auto& kernels = bass::kernels::active();
+    const int numChannels = buffer.getNumChannels();
+    const int capacity = static_cast<int>(scratch.ampEnv.size());
+    const bool tapActive = feedTelemetry && numChannels > 0 && telemetry.isActive();
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    const float sampleRate = block.sampleRate;
+    const float accentVelocity = juce::jlimit(0.0f, 1.0f, (lastVelocity - 0.55f) * 2.2f);
+    const float accentBoost = block.accent * accentVelocity;
+    const float driveGain = 1.0f + 15.0f * block.drive * (1.0f + 0.5f * accentBoost);
+    const float velocityGain = (0.25f + 0.75f * lastVelocity) * (1.0f + 0.22f * accentBoost);
+    const float fmDepthHz = block.fmAmt * 600.0f;
+    const float radiansPerHz = twoPi / sampleRate;
+    const float r2 = 1.0f / block.resonance;
+
+    // Add controlled post-filter low-end bloom for a fatter body.
+    const float bloomCoeff = 0.030f;
+    const float bloomAmount = (0.14f + 0.34f * block.subMix) * (1.0f + 0.24f * block.drive);
+
+    bass::kernels::VoiceShapeArgs shape;
+    shape.mainPhase = scratch.mainPhase.data();
+    shape.lfo = scratch.lfo.data();
+    shape.sub = scratch.sub.data();
+    shape.noise = scratch.noise.data();
+    shape.voice = scratch.voice.data();
+    shape.oscMix = block.oscMix;
+    shape.subMix = block.subMix;
+    shape.fmAmt = block.fmAmt;
+    shape.fold = block.fold;
+    shape.noiseLevel = block.noise;
+    shape.driveGain = driveGain;
+    shape.driveTrim = 1.0f / std::sqrt(juce::jmax(1.0f, driveGain));
+
+    bass::kernels::FilterCoefficientArgs coefficients;
+    coefficients.filterEnv = scratch.filterEnv.data();
+    coefficients.lfo = scratch.lfo.data();
+    coefficients.gL = scratch.gL.data();
+    coefficients.hL = scratch.hL.data();
+    coefficients.gR = scratch.gR.data();
+    coefficients.hR = scratch.hR.data();
+    coefficients.cutoff = block.cutoff;
+    coefficients.envAmount = block.envAmt + (accentBoost * 0.45f);
+    coefficients.lfoToCutoff = block.lfoToCutoff;
+    coefficients.stereo = block.stereo;
+    coefficients.resonance = block.resonance;
+    coefficients.sampleRate = sampleRate;
+
+    // Serial recurrences (glide, phase accumulators, filters) run as plain scalar loops; everything
+    // element-wise between them goes through the dispatched kernels.
+    while (startSample < endSample)
     {
-        currentFrequency = glideCoeff * currentFrequency + (1.0f - glideCoeff) * targetFrequency;
-        currentFrequency = juce::jlimit(20.0f, 12000.0f, currentFrequency);
-
-        const float lfo = std::sin(lfoPhase);
-        lfoPhase += lfoIncrement;
-        if (lfoPhase >= twoPi)
-            lfoPhase -= twoPi;
-
-        const float fmOsc = std::sin(phaseFm);
-        const float fmHz = fmOsc * (fmAmt * 600.0f);
-
-        const float phaseIncrementMain = twoPi * (currentFrequency + fmHz) / sampleRate;
-        const float phaseIncrementSub = twoPi * (currentFrequency * 0.5f) / sampleRate;
-        const float phaseIncrementFm = twoPi * (currentFrequency * fmRatio) / sampleRate;
-
-        const float phaseNorm = phaseMain / twoPi;
-        const float saw = (2.0f * phaseNorm) - 1.0f;
-        const float pulseWidth = juce::jlimit(0.12f, 0.88f, 0.49f + 0.18f * lfo * (0.2f + fmAmt));
-        const float pulse = phaseNorm < pulseWidth ? 1.0f : -1.0f;
-        const float mainOsc = juce::jmap(oscMix, saw, pulse);
-
-        const float subPure = std::sin(phaseSub);
-        const float subSaturated = softClip(subPure * (1.7f + subMix * 0.9f));
-        const float subOsc = juce::jmap(0.34f + subMix * 0.5f, subPure, subSaturated);
-        const float noiseSig = random.nextFloat() * 2.0f - 1.0f;
-
-        float voice = (mainOsc * (1.0f - subMix * 0.9f)) + (subOsc * (subMix * 1.08f));
-        voice += noiseSig * noise;
-
-        voice = waveFold(voice, fold);
-        voice = softClip(voice * driveGain) * driveTrim;
-
-        const float ampValue = ampEnv.getNextSample();
-        const float filtEnv = filterEnv.getNextSample();
-
-        const float envAmtWithAccent = envAmt + (accentBoost * 0.45f);
-        const float cutoffModSemis = envAmtWithAccent * (filtEnv - 0.2f) * 72.0f + lfo * lfoToCutoff * 36.0f;
-        const float cutoffL = juce::jlimit(20.0f, 18000.0f, cutoff * std::pow(2.0f, cutoffModSemis / 12.0f));
-        const float cutoffR = juce::jlimit(20.0f, 18000.0f, cutoffL * std::pow(2.0f, (stereo * lfo * 4.0f) / 12.0f));
-
-        filterL.setCutoffFrequency(cutoffL);
-        filterR.setCutoffFrequency(cutoffR);
-        filterL.setResonance(resonance);
-        filterR.setResonance(resonance);
-
-        const float velocityGain = (0.25f + 0.75f * lastVelocity) * (1.0f + 0.22f * accentBoost);
-        const float monoSignal = voice * ampValue * velocityGain;
-        float left = filterL.processSample(0, monoSignal);
-        float right = filterR.processSample(0, monoSignal);
-
-        // Add controlled post-filter low-end bloom for a fatter body.
-        const float bloomCoeff = 0.030f;
-        bassBloomStateL += bloomCoeff * (left - bassBloomStateL);
-        bassBloomStateR += bloomCoeff * (right - bassBloomStateR);
-        const float bloomAmount = (0.14f + 0.34f * subMix) * (1.0f + 0.24f * drive);
-        left += softClip(bassBloomStateL * 2.4f) * bloomAmount;
-        right += softClip(bassBloomStateR * 2.4f) * bloomAmount;
-        left = softClip(left * 0.9f);
-        right = softClip(right * 0.9f);
+        const int chunk = juce::jmin(endSample - startSample, capacity);
+
+        BassEnvelope::renderPair(ampEnv, filterEnv, scratch.ampEnv.data(), scratch.filterEnv.data(), chunk);
+
+        for (int i = 0; i < chunk; ++i)
+        {
+            currentFrequency = block.glideCoeff * currentFrequency + (1.0f - block.glideCoeff) * targetFrequency;
+            currentFrequency = juce::jlimit(20.0f, 12000.0f, currentFrequency);
+
+            scratch.lfoPhase[static_cast<size_t>(i)] = lfoPhase;
+            scratch.fmPhase[static_cast<size_t>(i)] = phaseFm;
+            scratch.subPhase[static_cast<size_t>(i)] = phaseSub;
+            scratch.mainPhase[static_cast<size_t>(i)] = currentFrequency;
+
+            lfoPhase += block.lfoIncrement;
+            if (lfoPhase >= twoPi)
+                lfoPhase -= twoPi;
+
+            phaseSub += radiansPerHz * (currentFrequency * 0.5f);
+            if (phaseSub >= twoPi)
+                phaseSub -= twoPi;
+
+            phaseFm += radiansPerHz * (currentFrequency * block.fmRatio);
+            if (phaseFm >= twoPi)
+                phaseFm -= twoPi;
+        }
+
+        kernels.sine(scratch.lfoPhase.data(), scratch.lfo.data(), chunk);
+        kernels.sine(scratch.fmPhase.data(), scratch.fm.data(), chunk);
+        kernels.sine(scratch.subPhase.data(), scratch.sub.data(), chunk);
+
+        // The main oscillator's increment depends on the FM sine, so its phase is accumulated
+        // after the sine pass. mainPhase holds the glided frequency until it is overwritten here.
+        for (int i = 0; i < chunk; ++i)
+        {
+            const auto index = static_cast<size_t>(i);
+            const float frequency = scratch.mainPhase[index];
+            scratch.mainPhase[index] = phaseMain;
+
+            phaseMain += radiansPerHz * (frequency + scratch.fm[index] * fmDepthHz);
+            if (phaseMain >= twoPi)
+                phaseMain -= twoPi;
+        }
+
+        kernels.noise(noiseCounter, scratch.noise.data(), chunk);
+        noiseCounter += static_cast<juce::uint32>(chunk);
+
+        kernels.shapeVoice(shape, chunk);
+        kernels.filterCoefficients(coefficients, chunk);
+
+        for (int i = 0; i < chunk; ++i)
+        {
+            const auto index = static_cast<size_t>(i);
+            const float monoSignal = scratch.voice[index] * scratch.ampEnv[index] * velocityGain;
+
+            const float left = processFilterSample(filterStateL, monoSignal, scratch.gL[index], scratch.hL[index], r2);
+            const float right = processFilterSample(filterStateR, monoSignal, scratch.gR[index], scratch.hR[index], r2);
+
+            bassBloomStateL += bloomCoeff * (left - bassBloomStateL);
+            bassBloomStateR += bloomCoeff * (right - bassBloomStateR);
+
+            scratch.left[index] = left;
+            scratch.right[index] = right;
+            scratch.bloomL[index] = bassBloomStateL;
+            scratch.bloomR[index] = bassBloomStateR;
+        }
 
         if (numChannels > 0)
-            buffer.setSample(0, sample, left * outputGain);
+            kernels.outputStage(scratch.left.data(), scratch.bloomL.data(), bloomAmount, block.outputGain,
+                                buffer.getWritePointer(0, startSample), chunk);
         if (numChannels > 1)
-            buffer.setSample(1, sample, right * outputGain);
-
-        phaseMain += phaseIncrementMain;
-        phaseSub += phaseIncrementSub;
-        phaseFm += phaseIncrementFm;
-
-        if (phaseMain >= twoPi)
-            phaseMain -= twoPi;
-        if (phaseSub >= twoPi)
-            phaseSub -= twoPi;
-        if (phaseFm >= twoPi)
-            phaseFm -= twoPi;
+            kernels.outputStage(scratch.right.data(), scratch.bloomR.data(), bloomAmount, block.outputGain,
+                                buffer.getWritePointer(1, startSample), chunk);
+
+        if (tapActive)
+            telemetry.capture(buffer.getReadPointer(0, startSample),
+                              numChannels > 1 ? buffer.getReadPointer(1, startSample) : nullptr,
+                              scratch.ampEnv.data(), scratch.filterEnv.data(), scratch.gL.data(), chunk);
+
+        startSample += chunk;
     }
 }
 
@@ -7,6 +7,11 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include "BassEnvelope.h"
+#include "BassKernels.h"
+#include "BassNoteCache.h"
+#include "BassTelemetry.h"
+
 class AphexBassAudioProcessor final : public juce::AudioProcessor
 {
 public:
@@ -15,6 +20,7 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
@@ -38,28 +44,117 @@ public:
     void setStateInformation(const void*, int) override;
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return parameters; }
+    TelemetryTap& getTelemetry() { return telemetry; }
+
+    // Restarts the LFO, oscillator phases, noise and filters on every note that starts from
+    // silence, so those onsets sound the same each time. Off by default; not a host parameter.
+    void setLfoRetrigger(bool shouldRetrigger) { lfoRetrigger = shouldRetrigger; }
+
+    // Memory budget of the note-render cache, which only runs while rendering non-realtime with
+    // LFO retrigger on. Zero disables it. Call while the processor isn't rendering.
+    void setNoteCacheSize(size_t bytes);
+    NoteCacheStats getNoteCacheStats() const { return noteCache.getStats(); }
 
 private:
+    // Parameter values read once per block and shared by every sub-block between MIDI events.
+    struct BlockParameters
+    {
+        float oscMix = 0.0f;
+        float subMix = 0.0f;
+        float fmAmt = 0.0f;
+        float fmRatio = 1.0f;
+        float fold = 0.0f;
+        float drive = 0.0f;
+        float noise = 0.0f;
+        float cutoff = 220.0f;
+        float resonance = 0.0f;
+        float envAmt = 0.0f;
+        float lfoToCutoff = 0.0f;
+        float stereo = 0.0f;
+        float accent = 0.0f;
+        float outputGain = 1.0f;
+        float sampleRate = 44100.0f;
+        float glideCoeff = 0.0f;
+        float lfoIncrement = 0.0f;
+    };
+
+    // Per-sample work lanes for one render chunk, sized in prepareToPlay.
+    struct VoiceScratch
+    {
+        void resize(size_t numSamples);
+
+        std::vector<float> ampEnv, filterEnv;
+        std::vector<float> lfoPhase, lfo, fmPhase, fm, subPhase, sub, mainPhase;
+        std::vector<float> noise, voice;
+        std::vector<float> gL, hL, gR, hR;
+        std::vector<float> left, right, bloomL, bloomR;
+    };
+
+    struct FilterState
+    {
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+    };
+
+    // Everything renderVoice advances. Values only MIDI events change (target frequency,
+    // velocity, held notes) stay live. A member missing here makes cached renders drift;
+    // DBassStressHarness --check-cache compares cached and uncached output to catch that.
+    struct VoiceState
+    {
+        BassEnvelope ampEnv;
+        BassEnvelope filterEnv;
+        FilterState filterL;
+        FilterState filterR;
+        float phaseMain = 0.0f;
+        float phaseSub = 0.0f;
+        float phaseFm = 0.0f;
+        float lfoPhase = 0.0f;
+        float currentFrequency = 0.0f;
+        float bloomL = 0.0f;
+        float bloomR = 0.0f;
+        juce::uint32 noiseCounter = 0;
+    };
+
+    using NoteCache = NoteRenderCache<VoiceState>;
+
+    enum class CacheMode
+    {
+        off,
+        recording,
+        replaying
+    };
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    static float processFilterSample(FilterState& state, float input, float g, float h, float r2);
 
+    void handleMidiMessage(const juce::MidiMessage& message);
+    void renderVoice(juce::AudioBuffer<float>& buffer, int startSample, int endSample, const BlockParameters& block,
+                     bool feedTelemetry = true);
     void noteOn(int midiNote, float velocity);
     void noteOff(int midiNote);
     void retargetFrequencyFromHeldNotes();
 
-    static float softClip(float x);
-    static float waveFold(float x, float amount);
+    bool noteCacheAllowed(int numChannels) const;
+    NoteCache::Key makeCacheKey(int numChannels) const;
+    VoiceState captureVoiceState() const;
+    void restoreVoiceState(const VoiceState& state);
+    void beginCachedNote(NoteCache::Key key, const BlockParameters& block);
+    void leaveCachedNote();
+    void renderSegment(juce::AudioBuffer<float>& buffer, int startSample, int endSample, const BlockParameters& block);
 
     double currentSampleRate = 44100.0;
 
     juce::AudioProcessorValueTreeState parameters;
 
-    juce::ADSR ampEnv;
-    juce::ADSR filterEnv;
-    juce::ADSR::Parameters ampEnvParams;
-    juce::ADSR::Parameters filterEnvParams;
+    BassEnvelope ampEnv;
+    BassEnvelope filterEnv;
+    BassEnvelope::Parameters ampEnvParams { -1.0f, -1.0f, -1.0f, -1.0f }; // Matches no real setting, so the first block applies both.
+    BassEnvelope::Parameters filterEnvParams;
+    VoiceScratch scratch;
+    TelemetryTap telemetry;
 
-    juce::dsp::StateVariableTPTFilter<float> filterL;
-    juce::dsp::StateVariableTPTFilter<float> filterR;
+    FilterState filterStateL;
+    FilterState filterStateR;
 
     float phaseMain = 0.0f;
     float phaseSub = 0.0f;
@@ -73,6 +168,19 @@ private:
     float bassBloomStateR = 0.0f;
 
     std::vector<int> heldNotes;
+    juce::uint32 noiseCounter = 0;
+
+    bool lfoRetrigger = false;
+    int pendingOnsetNote = -1;
+
+    NoteCache noteCache;
+    CacheMode cacheMode = CacheMode::off;
+    NoteCache::Entry* cacheEntry = nullptr;
+    int cachePosition = 0;
+    BlockParameters cacheBlock;
+    float cacheTargetFrequency = 55.0f;
+    juce::AudioBuffer<float> cacheScratch;
+    std::array<std::atomic<float>*, bass::parameterIds.size()> cacheKeyParams {};
 
     std::atomic<float>* outputParam = nullptr;
     std::atomic<float>* tuneParam = nullptr;
@@ -0,0 +1,131 @@
+#include "BassTelemetry.h"
+
+#include <cmath>
+
+TelemetryTap::TelemetryTap()
+{
+    resetAccumulators();
+}
+
+void TelemetryTap::prepare(double newSampleRate)
+{
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+}
+
+bool TelemetryTap::attachConsumer()
+{
+    // A second reader would take every other frame from the first.
+    bool expected = false;
+    if (!consumerAttached.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        return false;
+
+    // A new generation tells the audio thread to drop whatever half-built frame it had.
+    generation.fetch_add(1, std::memory_order_relaxed);
+
+    // Frames left over from the previous consumer are stale; discard them from the reading side so
+    // the new view starts with live audio.
+    fifo.finishedRead(fifo.getNumReady());
+    capturing.store(true, std::memory_order_release);
+    return true;
+}
+
+void TelemetryTap::detachConsumer()
+{
+    capturing.store(false, std::memory_order_release);
+    consumerAttached.store(false, std::memory_order_release);
+}
+
+int TelemetryTap::pop(Frame* dest, int maxFrames)
+{
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+    fifo.prepareToRead(maxFrames, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        dest[i] = frames[static_cast<size_t>(start1 + i)];
+    for (int i = 0; i < size2; ++i)
+        dest[size1 + i] = frames[static_cast<size_t>(start2 + i)];
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+double TelemetryTap::getNanosecondsPerSample() const
+{
+    const auto samples = capturedSamples.load(std::memory_order_relaxed);
+    if (samples == 0)
+        return 0.0;
+
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(captureTicks.load(std::memory_order_relaxed));
+    return 1.0e9 * seconds / static_cast<double>(samples);
+}
+
+void TelemetryTap::resetAccumulators()
+{
+    pending = {};
+    sumSquares = {};
+    decimationSum = 0.0f;
+    decimationCount = 0;
+    waveformIndex = 0;
+}
+
+void TelemetryTap::capture(const float* left, const float* right, const float* ampEnv, const float* filterEnv,
+                           const float* cutoffG, int numSamples)
+{
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (const int current = generation.load(std::memory_order_relaxed); current != seenGeneration)
+    {
+        seenGeneration = current;
+        resetAccumulators();
+    }
+
+    if (right == nullptr)
+        right = left;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float l = left[i];
+        const float r = right[i];
+
+        pending.peak[0] = juce::jmax(pending.peak[0], std::abs(l));
+        pending.peak[1] = juce::jmax(pending.peak[1], std::abs(r));
+        sumSquares[0] += l * l;
+        sumSquares[1] += r * r;
+
+        decimationSum += l + r;
+        if (++decimationCount < decimation)
+            continue;
+
+        pending.waveform[static_cast<size_t>(waveformIndex)] = decimationSum * (0.5f / static_cast<float>(decimation));
+        decimationSum = 0.0f;
+        decimationCount = 0;
+
+        if (++waveformIndex == waveformPoints)
+            finishFrame(ampEnv[i], filterEnv[i], cutoffG[i]);
+    }
+
+    captureTicks.fetch_add(juce::Time::getHighResolutionTicks() - startTicks, std::memory_order_relaxed);
+    capturedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+}
+
+void TelemetryTap::finishFrame(float ampEnv, float filterEnv, float cutoffG)
+{
+    constexpr float invFrame = 1.0f / static_cast<float>(samplesPerFrame);
+    pending.rms[0] = std::sqrt(sumSquares[0] * invFrame);
+    pending.rms[1] = std::sqrt(sumSquares[1] * invFrame);
+    pending.ampEnv = ampEnv;
+    pending.filterEnv = filterEnv;
+
+    // The filter stores g = tan(pi * fc / fs); invert it once per frame rather than per sample.
+    pending.cutoffHz = static_cast<float>(std::atan(cutoffG) * getSampleRate() / juce::MathConstants<double>::pi);
+
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 > 0)
+        frames[static_cast<size_t>(start1)] = pending;
+    else
+        droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    fifo.finishedWrite(size1);
+
+    resetAccumulators();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <juce_core/juce_core.h>
+
+// Audio-thread side of the editor's scope, spectrum and meters.
+//
+// The audio thread folds its output into fixed-size frames (peak/RMS per channel, a 4x decimated
+// mono waveform and the envelope/cutoff values at the end of the frame) and pushes each finished
+// frame into a wait-free single-producer/single-consumer FIFO. The editor drains it on a timer.
+// With no consumer attached, processBlock skips the tap entirely.
+class TelemetryTap
+{
+public:
+    static constexpr int decimation = 4;
+    static constexpr int waveformPoints = 64;
+    static constexpr int samplesPerFrame = waveformPoints * decimation;
+    static constexpr int fifoFrames = 64;
+
+    struct Frame
+    {
+        std::array<float, 2> peak {};
+        std::array<float, 2> rms {};
+        float ampEnv = 0.0f;
+        float filterEnv = 0.0f;
+        float cutoffHz = 0.0f;
+        std::array<float, waveformPoints> waveform {};
+    };
+
+    TelemetryTap();
+
+    void prepare(double sampleRate);
+    double getSampleRate() const { return sampleRate.load(std::memory_order_relaxed); }
+
+    // Consumer (message thread). The FIFO has a single reader, so attaching fails while another
+    // consumer is attached.
+    bool attachConsumer();
+    void detachConsumer();
+    int pop(Frame* dest, int maxFrames);
+    juce::uint64 getDroppedFrames() const { return droppedFrames.load(std::memory_order_relaxed); }
+    double getNanosecondsPerSample() const;
+
+    // Producer (audio thread).
+    bool isActive() const { return capturing.load(std::memory_order_relaxed); }
+    void capture(const float* left, const float* right, const float* ampEnv, const float* filterEnv,
+                 const float* cutoffG, int numSamples);
+
+private:
+    void resetAccumulators();
+    void finishFrame(float ampEnv, float filterEnv, float cutoffG);
+
+    juce::AbstractFifo fifo { fifoFrames };
+    std::array<Frame, fifoFrames> frames;
+
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<bool> consumerAttached { false };
+    std::atomic<bool> capturing { false };
+    std::atomic<int> generation { 0 };
+    std::atomic<juce::uint64> droppedFrames { 0 };
+    std::atomic<juce::int64> captureTicks { 0 };
+    std::atomic<juce::int64> capturedSamples { 0 };
+
+    // Audio-thread accumulators for the frame in progress.
+    Frame pending;
+    int seenGeneration = -1;
+    std::array<float, 2> sumSquares {};
+    float decimationSum = 0.0f;
+    int decimationCount = 0;
+    int waveformIndex = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(TelemetryTap)
+};
@@ -0,0 +1,220 @@
+#include "BassTelemetryView.h"
+#include "BassPalette.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+using namespace bass::palette;
+
+constexpr float floorDb = -72.0f;
+constexpr float meterFall = 0.82f;
+
+float gainToMeter(float gain)
+{
+    return juce::jmap(juce::jlimit(floorDb, 0.0f, juce::Decibels::gainToDecibels(gain, floorDb)), floorDb, 0.0f, 0.0f, 1.0f);
+}
+}
+
+BassTelemetryView::BassTelemetryView(TelemetryTap& tapToUse)
+    : tap(tapToUse),
+      attached(tap.attachConsumer()),
+      droppedAtOpen(tap.getDroppedFrames())
+{
+    spectrumDb.fill(floorDb);
+    if (attached)
+        startTimerHz(30);
+}
+
+BassTelemetryView::~BassTelemetryView()
+{
+    stopTimer();
+    if (attached)
+        tap.detachConsumer();
+}
+
+void BassTelemetryView::timerCallback()
+{
+    const int count = tap.pop(incoming.data(), static_cast<int>(incoming.size()));
+
+    for (auto& level : meterPeak)
+        level *= meterFall;
+    for (auto& level : meterRms)
+        level *= meterFall;
+
+    for (int i = 0; i < count; ++i)
+        consumeFrame(incoming[static_cast<size_t>(i)]);
+
+    if (count > 0)
+        updateSpectrum();
+
+    repaint();
+}
+
+void BassTelemetryView::consumeFrame(const TelemetryTap::Frame& frame)
+{
+    for (const float point : frame.waveform)
+    {
+        scope[static_cast<size_t>(scopeWrite)] = point;
+        scopeWrite = (scopeWrite + 1) % scopePoints;
+
+        fftInput[static_cast<size_t>(fftWrite)] = point;
+        fftWrite = (fftWrite + 1) % fftSize;
+    }
+
+    for (size_t ch = 0; ch < 2; ++ch)
+    {
+        meterPeak[ch] = juce::jmax(meterPeak[ch], frame.peak[ch]);
+        meterRms[ch] = juce::jmax(meterRms[ch], frame.rms[ch]);
+    }
+
+    cutoffHz = frame.cutoffHz;
+    filterEnv = frame.filterEnv;
+}
+
+void BassTelemetryView::updateSpectrum()
+{
+    // Unroll the ring so the window sees the samples oldest first.
+    for (int i = 0; i < fftSize; ++i)
+        fftWork[static_cast<size_t>(i)] = fftInput[static_cast<size_t>((fftWrite + i) % fftSize)];
+    std::fill(fftWork.begin() + fftSize, fftWork.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftWork.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftWork.data());
+
+    const float scale = 4.0f / static_cast<float>(fftSize);
+    for (size_t bin = 0; bin < spectrumDb.size(); ++bin)
+    {
+        const float db = juce::Decibels::gainToDecibels(fftWork[bin] * scale, floorDb);
+        spectrumDb[bin] = juce::jmax(db, spectrumDb[bin] - 3.0f);
+    }
+}
+
+void BassTelemetryView::paint(juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+    const float gap = 5.0f;
+
+    auto meterArea = area.removeFromRight(150.0f);
+    area.removeFromRight(gap);
+    auto scopeArea = area.removeFromLeft((area.getWidth() - gap) * 0.5f);
+    area.removeFromLeft(gap);
+
+    for (const auto& section : { scopeArea, area, meterArea })
+    {
+        g.setColour(panel.brighter(0.02f));
+        g.fillRect(section);
+        g.setColour(phosphorDim.withAlpha(0.22f));
+        g.drawRect(section, 1.0f);
+    }
+
+    if (!attached)
+    {
+        g.setColour(phosphorDim);
+        g.setFont(juce::Font(juce::FontOptions(9.0f).withStyle("Bold")));
+        g.drawText("TELEMETRY IN USE BY ANOTHER EDITOR", scopeArea, juce::Justification::centred, false);
+        return;
+    }
+
+    paintScope(g, scopeArea.reduced(4.0f));
+    paintSpectrum(g, area.reduced(4.0f));
+    paintMeter(g, meterArea.reduced(4.0f));
+}
+
+void BassTelemetryView::paintScope(juce::Graphics& g, juce::Rectangle<float> bounds) const
+{
+    g.setColour(phosphorDim.withAlpha(0.35f));
+    g.drawHorizontalLine(juce::roundToInt(bounds.getCentreY()), bounds.getX(), bounds.getRight());
+
+    juce::Path trace;
+    for (int i = 0; i < scopePoints; ++i)
+    {
+        const float value = juce::jlimit(-1.0f, 1.0f, scope[static_cast<size_t>((scopeWrite + i) % scopePoints)]);
+        const float x = bounds.getX() + bounds.getWidth() * static_cast<float>(i) / static_cast<float>(scopePoints - 1);
+        const float y = bounds.getCentreY() - value * bounds.getHeight() * 0.5f;
+
+        if (i == 0)
+            trace.startNewSubPath(x, y);
+        else
+            trace.lineTo(x, y);
+    }
+
+    g.setColour(phosphor);
+    g.strokePath(trace, juce::PathStrokeType(1.2f));
+
+    g.setColour(phosphorDim);
+    g.setFont(juce::Font(juce::FontOptions(9.0f).withStyle("Bold")));
+    g.drawText("SCOPE", bounds.removeFromTop(12.0f), juce::Justification::topLeft, false);
+}
+
+void BassTelemetryView::paintSpectrum(juce::Graphics& g, juce::Rectangle<float> bounds) const
+{
+    // The tap delivers a 4x decimated signal, so the spectrum tops out at fs / 8.
+    const float nyquist = static_cast<float>(tap.getSampleRate()) / static_cast<float>(2 * TelemetryTap::decimation);
+    const float binHz = nyquist / static_cast<float>(spectrumDb.size());
+    const float minHz = 20.0f;
+    const float logSpan = std::log(nyquist / minHz);
+
+    juce::Path curve;
+    bool started = false;
+    for (size_t bin = 1; bin < spectrumDb.size(); ++bin)
+    {
+        const float hz = binHz * static_cast<float>(bin);
+        if (hz < minHz)
+            continue;
+
+        const float x = bounds.getX() + bounds.getWidth() * std::log(hz / minHz) / logSpan;
+        const float y = juce::jmap(spectrumDb[bin], floorDb, 0.0f, bounds.getBottom(), bounds.getY());
+
+        if (!started)
+            curve.startNewSubPath(x, y);
+        else
+            curve.lineTo(x, y);
+        started = true;
+    }
+
+    g.setColour(phosphor);
+    g.strokePath(curve, juce::PathStrokeType(1.2f));
+
+    if (cutoffHz > minHz && cutoffHz < nyquist)
+    {
+        const float x = bounds.getX() + bounds.getWidth() * std::log(cutoffHz / minHz) / logSpan;
+        g.setColour(phosphorHot.withAlpha(0.5f));
+        g.drawVerticalLine(juce::roundToInt(x), bounds.getY(), bounds.getBottom());
+    }
+
+    g.setColour(phosphorDim);
+    g.setFont(juce::Font(juce::FontOptions(9.0f).withStyle("Bold")));
+    g.drawText("SPECTRUM", bounds.removeFromTop(12.0f), juce::Justification::topLeft, false);
+}
+
+void BassTelemetryView::paintMeter(juce::Graphics& g, juce::Rectangle<float> bounds) const
+{
+    g.setFont(juce::Font(juce::FontOptions(9.0f).withStyle("Bold")));
+    g.setColour(phosphorDim);
+    g.drawText("OUT", bounds.removeFromTop(12.0f), juce::Justification::topLeft, false);
+
+    auto readout = bounds.removeFromRight(72.0f);
+    const float barWidth = (bounds.getWidth() - 6.0f) * 0.5f;
+
+    for (size_t ch = 0; ch < 2; ++ch)
+    {
+        auto bar = bounds.removeFromLeft(barWidth);
+        bounds.removeFromLeft(6.0f);
+
+        g.setColour(phosphorDim.withAlpha(0.25f));
+        g.fillRect(bar);
+        g.setColour(phosphorDim);
+        g.fillRect(bar.withTop(bar.getBottom() - bar.getHeight() * gainToMeter(meterRms[ch])));
+        g.setColour(phosphorHot);
+        const float peakY = bar.getBottom() - bar.getHeight() * gainToMeter(meterPeak[ch]);
+        g.drawHorizontalLine(juce::roundToInt(peakY), bar.getX(), bar.getRight());
+    }
+
+    g.setColour(phosphor);
+    g.drawFittedText("CUT " + juce::String(juce::roundToInt(cutoffHz)) + "\nENV " + juce::String(filterEnv, 2)
+                         + "\nTAP " + juce::String(tap.getNanosecondsPerSample(), 1) + "ns"
+                         + "\nDROP " + juce::String(tap.getDroppedFrames() - droppedAtOpen),
+                     readout.toNearestInt(), juce::Justification::centredLeft, 4);
+}
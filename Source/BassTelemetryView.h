@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <juce_dsp/juce_dsp.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "BassTelemetry.h"
+
+// Scope, spectrum and output meter fed from the processor's TelemetryTap at display rate.
+// Attaches itself as the tap's consumer for as long as it exists; if another view already has the
+// tap, it stays blank.
+class BassTelemetryView final : public juce::Component,
+                                private juce::Timer
+{
+public:
+    explicit BassTelemetryView(TelemetryTap&);
+    ~BassTelemetryView() override;
+
+    void paint(juce::Graphics&) override;
+
+private:
+    static constexpr int fftOrder = 10;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int scopePoints = 512;
+
+    void timerCallback() override;
+    void consumeFrame(const TelemetryTap::Frame& frame);
+    void updateSpectrum();
+
+    void paintScope(juce::Graphics&, juce::Rectangle<float>) const;
+    void paintSpectrum(juce::Graphics&, juce::Rectangle<float>) const;
+    void paintMeter(juce::Graphics&, juce::Rectangle<float>) const;
+
+    TelemetryTap& tap;
+    const bool attached;
+    const juce::uint64 droppedAtOpen;
+
+    std::array<TelemetryTap::Frame, TelemetryTap::fifoFrames> incoming;
+
+    std::array<float, scopePoints> scope {};
+    int scopeWrite = 0;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann };
+    std::array<float, fftSize> fftInput {};
+    int fftWrite = 0;
+    std::vector<float> fftWork = std::vector<float>(static_cast<size_t>(fftSize * 2), 0.0f);
+    std::array<float, fftSize / 2> spectrumDb {};
+
+    std::array<float, 2> meterPeak {};
+    std::array<float, 2> meterRms {};
+    float cutoffHz = 0.0f;
+    float filterEnv = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BassTelemetryView)
+};
@@ -0,0 +1,661 @@
+// Long-running headless renderer. Keeps a pool of prepared processors per
+// sample-rate/block-size pair and serves render jobs over stdin/stdout.
+//
+// Protocol: one JSON object per line on stdin, one JSON object per line on stdout.
+//
+//   {"id":1,"cmd":"render","sampleRate":48000,"blockSize":512,"numSamples":96000,"numChannels":2,
+//    "preset":"acid melt stomp" | "state":"<base64 getStateInformation blob>",
+//    "events":[{"sample":0,"type":"on","note":36,"velocity":0.9},{"sample":24000,"type":"off","note":36}],
+//    "lfoRetrigger":true, "shm":"/dbass-job-1"}
+//   {"id":2,"cmd":"stats"}
+//   {"cmd":"quit"}
+//
+// Jobs run concurrently, one worker thread per pooled instance, so replies can arrive out of
+// order; each reply carries the request's "id". "stats" is answered as soon as it is read, even
+// while every worker is busy. "quit" lets queued jobs finish, then exits.
+//
+// Only the configurations given to --warm are served, with at most maxBlockSize samples per block
+// and maxJobSamples per job, so the daemon's memory stays bounded whatever the requests say.
+//
+// Render output is planar float32 (all of channel 0, then channel 1). When "shm" names a POSIX
+// shared-memory object of at least numChannels * numSamples * 4 bytes, the processor renders
+// straight into the mapping and nothing is copied. Otherwise the reply line carries "bytes" and
+// is followed by exactly that many bytes of PCM on stdout.
+//
+// With --note-cache-mb, each pooled processor keeps a note cache for jobs that set lfoRetrigger.
+
+#include "BassPluginProcessor.h"
+#include "BassPresets.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define DBASS_HAS_POSIX_SHM 1
+#else
+ #define DBASS_HAS_POSIX_SHM 0
+#endif
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double millisecondsBetween(Clock::time_point a, Clock::time_point b)
+{
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+constexpr int minSampleRate = 8000;
+constexpr int maxSampleRate = 384000;
+constexpr int maxBlockSize = 16384;
+constexpr int maxJobSamples = 1 << 25; // About 11 minutes at 48 kHz, 256 MB of stereo output.
+
+struct PoolKey
+{
+    int sampleRate = 44100;
+    int blockSize = 512;
+
+    bool isValid() const
+    {
+        return sampleRate >= minSampleRate && sampleRate <= maxSampleRate && blockSize >= 1 && blockSize <= maxBlockSize;
+    }
+
+    bool operator<(const PoolKey& other) const
+    {
+        return std::tie(sampleRate, blockSize) < std::tie(other.sampleRate, other.blockSize);
+    }
+};
+
+// Rolling window of the most recent latencies, summarised on request.
+class LatencyWindow
+{
+public:
+    void add(double ms)
+    {
+        if (values.size() < capacity)
+            values.push_back(ms);
+        else
+            values[next] = ms;
+
+        next = (next + 1) % capacity;
+        ++count;
+    }
+
+    juce::var toVar() const
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("count", static_cast<juce::int64>(count));
+
+        if (!values.empty())
+        {
+            auto sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            const auto at = [&sorted](double q)
+            {
+                const auto index = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+                return sorted[std::min(index, sorted.size() - 1)];
+            };
+
+            obj->setProperty("p50", at(0.50));
+            obj->setProperty("p99", at(0.99));
+            obj->setProperty("max", sorted.back());
+        }
+
+        return juce::var(obj);
+    }
+
+private:
+    static constexpr size_t capacity = 4096;
+    std::vector<double> values;
+    size_t next = 0;
+    juce::uint64 count = 0;
+};
+
+struct Job
+{
+    juce::var request;
+    Clock::time_point received;
+};
+
+// Reads request lines on a background thread so queue depth and queueing delay are observable
+// while a render is in progress.
+class RequestQueue
+{
+public:
+    void push(Job job)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    void close()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        wake.notify_all();
+    }
+
+    bool pop(Job& job)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return closed || !jobs.empty(); });
+        if (jobs.empty())
+            return false;
+
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        return true;
+    }
+
+    size_t depth() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return jobs.size();
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    bool closed = false;
+};
+
+#if DBASS_HAS_POSIX_SHM
+class SharedMemoryMapping
+{
+public:
+    SharedMemoryMapping(const juce::String& name, size_t requiredBytes)
+    {
+        const int fd = shm_open(name.toRawUTF8(), O_RDWR, 0);
+        if (fd < 0)
+            return;
+
+        struct stat info {};
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= requiredBytes && requiredBytes > 0)
+        {
+            void* mapped = mmap(nullptr, requiredBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                data = mapped;
+                size = requiredBytes;
+            }
+        }
+
+        close(fd);
+    }
+
+    ~SharedMemoryMapping()
+    {
+        if (data != nullptr)
+            munmap(data, size);
+    }
+
+    float* floats() const { return static_cast<float*>(data); }
+    bool isValid() const { return data != nullptr; }
+
+private:
+    void* data = nullptr;
+    size_t size = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(SharedMemoryMapping)
+};
+#endif
+
+class RenderDaemon
+{
+public:
+    explicit RenderDaemon(size_t noteCacheBytesToUse)
+        : noteCacheBytes(noteCacheBytesToUse)
+    {
+        AphexBassAudioProcessor().getStateInformation(defaultState);
+    }
+
+    // Only warmed configurations are served; a pool of zero instances builds them on demand.
+    void warm(PoolKey key, int instances)
+    {
+        auto& pool = idle[key];
+        for (int i = 0; i < instances; ++i)
+            pool.push_back(createPrepared(key));
+    }
+
+    // Serves jobs until stdin closes or a quit arrives, with numWorkers jobs in flight at most.
+    void run(int numWorkers)
+    {
+        std::thread reader([this]
+        {
+            std::string line;
+            while (std::getline(std::cin, line))
+            {
+                if (line.empty())
+                    continue;
+
+                auto request = juce::JSON::parse(juce::String(line));
+                if (!request.isObject())
+                {
+                    replyError(request, "malformed request");
+                    continue;
+                }
+
+                const auto cmd = request.getProperty("cmd", "render").toString();
+                if (cmd == "quit")
+                    break;
+
+                if (cmd == "stats")
+                    reply(request, statsVar(), nullptr, 0);
+                else
+                    queue.push({ std::move(request), Clock::now() });
+            }
+            queue.close();
+        });
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < juce::jmax(1, numWorkers); ++i)
+            workers.emplace_back([this] { serve(); });
+
+        reader.join();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+private:
+    void serve()
+    {
+        Job job;
+        while (queue.pop(job))
+        {
+            const auto cmd = job.request.getProperty("cmd", "render").toString();
+            if (cmd == "render")
+                render(job);
+            else
+                replyError(job.request, "unknown cmd: " + cmd);
+        }
+    }
+
+    std::unique_ptr<AphexBassAudioProcessor> createPrepared(PoolKey key)
+    {
+        auto processor = std::make_unique<AphexBassAudioProcessor>();
+        processor->setNonRealtime(true);
+        processor->setRateAndBufferSizeDetails(key.sampleRate, key.blockSize);
+        processor->prepareToPlay(key.sampleRate, key.blockSize);
+
+        // Touch every code path once so the first real job doesn't pay for page faults.
+        juce::AudioBuffer<float> scratch(2, key.blockSize);
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 36, 1.0f), 0);
+        processor->processBlock(scratch, midi);
+        processor->reset();
+        processor->setNoteCacheSize(noteCacheBytes);
+
+        ++coldStarts;
+        return processor;
+    }
+
+    // Returns null for configurations that weren't warmed.
+    std::unique_ptr<AphexBassAudioProcessor> acquire(PoolKey key, bool& wasWarm)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(poolMutex);
+            const auto found = idle.find(key);
+            if (found == idle.end())
+                return nullptr;
+
+            auto& pool = found->second;
+            wasWarm = !pool.empty();
+            if (wasWarm)
+            {
+                auto processor = std::move(pool.back());
+                pool.pop_back();
+                ++busy[key];
+                return processor;
+            }
+
+            ++busy[key];
+        }
+
+        // Built outside the lock so other workers keep going while this one pays the cold start.
+        return createPrepared(key);
+    }
+
+    void release(PoolKey key, std::unique_ptr<AphexBassAudioProcessor> processor)
+    {
+        processor->reset();
+
+        const std::lock_guard<std::mutex> lock(poolMutex);
+        idle[key].push_back(std::move(processor));
+        --busy[key];
+    }
+
+    bool applyPatch(AphexBassAudioProcessor& processor, const juce::var& request, juce::String& error)
+    {
+        const auto stateBlob = request.getProperty("state", {}).toString();
+        if (stateBlob.isNotEmpty())
+        {
+            juce::MemoryBlock state;
+            if (!state.fromBase64Encoding(stateBlob))
+            {
+                error = "state is not valid base64";
+                return false;
+            }
+
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            return true;
+        }
+
+        processor.setStateInformation(defaultState.getData(), static_cast<int>(defaultState.getSize()));
+
+        const auto presetName = request.getProperty("preset", {}).toString();
+        if (presetName.isEmpty())
+            return true;
+
+        const auto* preset = bass::findPreset(presetName.toRawUTF8());
+        if (preset == nullptr)
+        {
+            error = "unknown preset: " + presetName;
+            return false;
+        }
+
+        bass::applyPreset(processor.getAPVTS(), *preset);
+        return true;
+    }
+
+    static juce::MidiBuffer collectEvents(const juce::var& events)
+    {
+        juce::MidiBuffer midi;
+        if (const auto* list = events.getArray())
+        {
+            for (const auto& event : *list)
+            {
+                const int sample = juce::jmax(0, static_cast<int>(event.getProperty("sample", 0)));
+                const int note = juce::jlimit(0, 127, static_cast<int>(event.getProperty("note", 36)));
+                const auto type = event.getProperty("type", "on").toString();
+
+                if (type == "on")
+                    midi.addEvent(juce::MidiMessage::noteOn(1, note, static_cast<float>(event.getProperty("velocity", 1.0))), sample);
+                else if (type == "off")
+                    midi.addEvent(juce::MidiMessage::noteOff(1, note), sample);
+                else if (type == "allNotesOff")
+                    midi.addEvent(juce::MidiMessage::allNotesOff(1), sample);
+            }
+        }
+
+        return midi;
+    }
+
+    void render(const Job& job)
+    {
+        const auto& request = job.request;
+        const PoolKey key { static_cast<int>(request.getProperty("sampleRate", 44100)),
+                            static_cast<int>(request.getProperty("blockSize", 512)) };
+        const int numSamples = static_cast<int>(request.getProperty("numSamples", 0));
+        const int numChannels = static_cast<int>(request.getProperty("numChannels", 2));
+
+        if (!key.isValid() || numSamples <= 0 || numSamples > maxJobSamples || numChannels < 1 || numChannels > 2)
+        {
+            replyError(request, "invalid render dimensions");
+            return;
+        }
+
+        bool wasWarm = false;
+        auto processor = acquire(key, wasWarm);
+        if (processor == nullptr)
+        {
+            replyError(request, "configuration not warmed: " + juce::String(key.sampleRate) + ":" + juce::String(key.blockSize));
+            return;
+        }
+
+        processor->setLfoRetrigger(static_cast<bool>(request.getProperty("lfoRetrigger", false)));
+        const auto cacheBefore = processor->getNoteCacheStats();
+
+        juce::String error;
+        if (!applyPatch(*processor, request, error))
+        {
+            release(key, std::move(processor));
+            replyError(request, error);
+            return;
+        }
+
+        const auto started = Clock::now();
+
+        const size_t totalFloats = static_cast<size_t>(numChannels) * static_cast<size_t>(numSamples);
+        float* destination = nullptr;
+        std::vector<float> inlineOutput;
+
+       #if DBASS_HAS_POSIX_SHM
+        std::unique_ptr<SharedMemoryMapping> mapping;
+        const auto shmName = request.getProperty("shm", {}).toString();
+        if (shmName.isNotEmpty())
+        {
+            mapping = std::make_unique<SharedMemoryMapping>(shmName, totalFloats * sizeof(float));
+            if (!mapping->isValid())
+            {
+                release(key, std::move(processor));
+                replyError(request, "cannot map shared memory: " + shmName);
+                return;
+            }
+
+            destination = mapping->floats();
+        }
+       #endif
+
+        if (destination == nullptr)
+        {
+            inlineOutput.resize(totalFloats);
+            destination = inlineOutput.data();
+        }
+
+        std::array<float*, 2> channels { destination, destination + (numChannels > 1 ? numSamples : 0) };
+        const auto events = collectEvents(request.getProperty("events", {}));
+
+        juce::MidiBuffer blockMidi;
+        for (int start = 0; start < numSamples; start += key.blockSize)
+        {
+            const int length = juce::jmin(key.blockSize, numSamples - start);
+
+            blockMidi.clear();
+            blockMidi.addEvents(events, start, length, -start);
+
+            juce::AudioBuffer<float> block(channels.data(), numChannels, start, length);
+            processor->processBlock(block, blockMidi);
+        }
+
+        const auto finished = Clock::now();
+        const auto cacheAfter = processor->getNoteCacheStats();
+        release(key, std::move(processor));
+
+        {
+            const std::lock_guard<std::mutex> lock(statsMutex);
+            startLatency.add(millisecondsBetween(job.received, started));
+            renderTime.add(millisecondsBetween(started, finished));
+            cacheTotals.hits += cacheAfter.hits - cacheBefore.hits;
+            cacheTotals.misses += cacheAfter.misses - cacheBefore.misses;
+            cacheTotals.samplesServed += cacheAfter.samplesServed - cacheBefore.samplesServed;
+            cacheTotals.evictions += cacheAfter.evictions - cacheBefore.evictions;
+            ++jobsDone;
+        }
+
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("ok", true);
+        obj->setProperty("warm", wasWarm);
+        obj->setProperty("numSamples", numSamples);
+        obj->setProperty("numChannels", numChannels);
+        obj->setProperty("startMs", millisecondsBetween(job.received, started));
+        obj->setProperty("renderMs", millisecondsBetween(started, finished));
+        obj->setProperty("queueDepth", static_cast<int>(queue.depth()));
+
+        if (inlineOutput.empty())
+        {
+            obj->setProperty("output", "shm");
+            reply(request, juce::var(obj), nullptr, 0);
+        }
+        else
+        {
+            obj->setProperty("output", "inline");
+            reply(request, juce::var(obj), inlineOutput.data(), inlineOutput.size() * sizeof(float));
+        }
+    }
+
+    juce::var statsVar()
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("ok", true);
+        obj->setProperty("queueDepth", static_cast<int>(queue.depth()));
+        obj->setProperty("coldStarts", static_cast<juce::int64>(coldStarts.load()));
+        obj->setProperty("kernels", juce::String(bass::kernels::active().name));
+
+        NoteCacheStats cache;
+        {
+            const std::lock_guard<std::mutex> lock(statsMutex);
+            obj->setProperty("jobs", static_cast<juce::int64>(jobsDone));
+            obj->setProperty("startLatencyMs", startLatency.toVar());
+            obj->setProperty("renderMs", renderTime.toVar());
+            cache = cacheTotals;
+        }
+
+        // Hit/miss counters accumulate per job; memory in use is only read from idle instances.
+        juce::Array<juce::var> pools;
+        {
+            const std::lock_guard<std::mutex> lock(poolMutex);
+            for (const auto& [key, instances] : idle)
+            {
+                for (const auto& instance : instances)
+                {
+                    const auto instanceStats = instance->getNoteCacheStats();
+                    cache.entries += instanceStats.entries;
+                    cache.bytes += instanceStats.bytes;
+                }
+
+                auto* pool = new juce::DynamicObject();
+                pool->setProperty("sampleRate", key.sampleRate);
+                pool->setProperty("blockSize", key.blockSize);
+                pool->setProperty("idle", static_cast<int>(instances.size()));
+                pool->setProperty("busy", busy[key]);
+                pools.add(juce::var(pool));
+            }
+        }
+        obj->setProperty("pools", pools);
+
+        auto* noteCache = new juce::DynamicObject();
+        noteCache->setProperty("hits", static_cast<juce::int64>(cache.hits));
+        noteCache->setProperty("misses", static_cast<juce::int64>(cache.misses));
+        noteCache->setProperty("samplesServed", static_cast<juce::int64>(cache.samplesServed));
+        noteCache->setProperty("evictions", static_cast<juce::int64>(cache.evictions));
+        noteCache->setProperty("entries", static_cast<juce::int64>(cache.entries));
+        noteCache->setProperty("bytes", static_cast<juce::int64>(cache.bytes));
+        obj->setProperty("noteCache", juce::var(noteCache));
+
+        return juce::var(obj);
+    }
+
+    void reply(const juce::var& request, juce::var response, const void* payload, size_t payloadBytes)
+    {
+        if (auto* obj = response.getDynamicObject())
+        {
+            if (request.hasProperty("id"))
+                obj->setProperty("id", request.getProperty("id", {}));
+            if (payload != nullptr)
+                obj->setProperty("bytes", static_cast<juce::int64>(payloadBytes));
+        }
+
+        const auto line = juce::JSON::toString(response, true) + "\n";
+
+        // The reply line and its payload go out together, whatever other workers are doing.
+        const std::lock_guard<std::mutex> lock(outputMutex);
+        std::fwrite(line.toRawUTF8(), 1, line.getNumBytesAsUTF8(), stdout);
+        if (payload != nullptr)
+            std::fwrite(payload, 1, payloadBytes, stdout);
+        std::fflush(stdout);
+    }
+
+    void replyError(const juce::var& request, const juce::String& message)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("ok", false);
+        obj->setProperty("error", message);
+        reply(request, juce::var(obj), nullptr, 0);
+    }
+
+    std::mutex poolMutex;
+    std::map<PoolKey, std::vector<std::unique_ptr<AphexBassAudioProcessor>>> idle;
+    std::map<PoolKey, int> busy;
+
+    std::mutex statsMutex;
+    LatencyWindow startLatency;
+    LatencyWindow renderTime;
+    NoteCacheStats cacheTotals;
+    juce::uint64 jobsDone = 0;
+    std::atomic<juce::uint64> coldStarts { 0 };
+
+    std::mutex outputMutex;
+    juce::MemoryBlock defaultState;
+    RequestQueue queue;
+    size_t noteCacheBytes = 0;
+};
+
+void printUsage()
+{
+    std::fputs("usage: DBassRenderDaemon [--warm RATE:BLOCK[,RATE:BLOCK...]] [--pool N] [--note-cache-mb N]\n"
+               "  --warm           configurations to serve, prepared up front (default 44100:512,48000:512)\n"
+               "  --pool           prepared instances per configuration and concurrent jobs (default 2)\n"
+               "  --note-cache-mb  note cache budget per instance for lfoRetrigger jobs (default 0, off)\n",
+               stderr);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray configs { "44100:512", "48000:512" };
+    int poolSize = 2;
+    int noteCacheMegabytes = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        if (arg == "--warm" && i + 1 < argc)
+            configs = juce::StringArray::fromTokens(argv[++i], ",", {});
+        else if (arg == "--pool" && i + 1 < argc)
+            poolSize = juce::jmax(0, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--note-cache-mb" && i + 1 < argc)
+            noteCacheMegabytes = juce::jmax(0, juce::String(argv[++i]).getIntValue());
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    RenderDaemon daemon(static_cast<size_t>(noteCacheMegabytes) << 20);
+    for (const auto& config : configs)
+    {
+        const PoolKey key { config.upToFirstOccurrenceOf(":", false, false).getIntValue(),
+                            config.fromFirstOccurrenceOf(":", false, false).getIntValue() };
+        if (key.isValid())
+            daemon.warm(key, poolSize);
+    }
+
+    daemon.run(poolSize);
+    return 0;
+}
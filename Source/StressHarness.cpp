@@ -0,0 +1,405 @@
+// Headless worst-case timing harness for processBlock.
+//
+// Runs the processor through hostile scenarios and records the wall time of every block, then
+// reports p50/p99/p99.9/max per scenario against the real-time deadline of one block. Output
+// samples are checked for NaN/Inf. processBlock runs with denormals flushed, so denormal-prone
+// tails show up as block time rather than in the output. The exit code is non-zero if any
+// scenario produces non-finite output or its max block time exceeds --budget-us.
+//
+// With --check-cache each scenario is also rendered offline with LFO retrigger twice, with and
+// without the note cache, and the two outputs must match bit for bit. This catches voice state
+// that renderVoice advances but the cache's snapshots don't capture.
+
+#include "BassPluginProcessor.h"
+#include "BassPresets.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    double sampleRate = 48000.0;
+    int blockSize = 128;
+    int blocks = 20000;
+    double budgetMicros = 0.0;
+    bool histogram = false;
+    bool telemetry = false;
+    bool checkCache = false;
+    juce::String onlyScenario;
+    juce::String kernels;
+};
+
+struct ScenarioResult
+{
+    std::vector<double> blockMicros;
+    juce::int64 nonFiniteSamples = 0;
+    double tapNanosPerSample = 0.0;
+};
+
+struct CacheCheckResult
+{
+    NoteCacheStats cache;
+    juce::int64 mismatchedSamples = 0;
+};
+
+// Called before each block. May push MIDI, move parameters or load state.
+using BlockHook = std::function<void(AphexBassAudioProcessor&, juce::MidiBuffer&, int blockIndex)>;
+
+struct Scenario
+{
+    const char* name;
+    const char* description;
+    BlockHook beforeBlock;
+};
+
+// Goes through setValueNotifyingHost so the APVTS updates the raw values the DSP reads;
+// a bare setValue() would leave them untouched.
+void setNormalised(AphexBassAudioProcessor& processor, const char* id, float normalised)
+{
+    if (auto* parameter = processor.getAPVTS().getParameter(id))
+        parameter->setValueNotifyingHost(normalised);
+}
+
+void setNormalised(AphexBassAudioProcessor& processor, int index, float normalised)
+{
+    setNormalised(processor, bass::parameterIds[static_cast<size_t>(index)], normalised);
+}
+
+juce::MemoryBlock stateForPreset(const bass::PresetData& preset)
+{
+    AphexBassAudioProcessor scratch;
+    bass::applyPreset(scratch.getAPVTS(), preset);
+
+    juce::MemoryBlock state;
+    scratch.getStateInformation(state);
+    return state;
+}
+
+std::vector<Scenario> makeScenarios(const Options& options)
+{
+    auto random = std::make_shared<juce::Random>(0x0dba55);
+    auto presetStates = std::make_shared<std::vector<juce::MemoryBlock>>();
+    for (const auto& preset : bass::presets)
+        presetStates->push_back(stateForPreset(preset));
+
+    const int blocksPerSecond = juce::jmax(1, static_cast<int>(options.sampleRate / options.blockSize));
+
+    std::vector<Scenario> scenarios;
+
+    scenarios.push_back({ "steady", "default patch, one note per half second",
+        [blocksPerSecond](AphexBassAudioProcessor&, juce::MidiBuffer& midi, int block)
+        {
+            const int period = juce::jmax(2, blocksPerSecond / 2);
+            if (block % period == 0)
+                midi.addEvent(juce::MidiMessage::noteOn(1, 36, 0.8f), 0);
+            else if (block % period == period / 2)
+                midi.addEvent(juce::MidiMessage::noteOff(1, 36), 0);
+        } });
+
+    scenarios.push_back({ "midi-flood", "64 note on/off events per block at random offsets",
+        [random, blockSize = options.blockSize](AphexBassAudioProcessor&, juce::MidiBuffer& midi, int)
+        {
+            for (int i = 0; i < 32; ++i)
+            {
+                const int note = 24 + random->nextInt(48);
+                midi.addEvent(juce::MidiMessage::noteOn(1, note, random->nextFloat()), random->nextInt(blockSize));
+                midi.addEvent(juce::MidiMessage::noteOff(1, 24 + random->nextInt(48)), random->nextInt(blockSize));
+            }
+        } });
+
+    scenarios.push_back({ "automation", "all 22 parameters jump to random values every block",
+        [random](AphexBassAudioProcessor& processor, juce::MidiBuffer& midi, int block)
+        {
+            for (int i = 0; i < static_cast<int>(bass::parameterIds.size()); ++i)
+                setNormalised(processor, i, random->nextFloat());
+
+            if (block % 16 == 0)
+                midi.addEvent(juce::MidiMessage::noteOn(1, 24 + random->nextInt(48), 1.0f), 0);
+        } });
+
+    scenarios.push_back({ "extremes", "every parameter pinned to range ends, flipping every 8 blocks",
+        [](AphexBassAudioProcessor& processor, juce::MidiBuffer& midi, int block)
+        {
+            if (block % 8 != 0)
+                return;
+
+            const bool high = (block / 8) % 2 == 0;
+            for (int i = 0; i < static_cast<int>(bass::parameterIds.size()); ++i)
+                setNormalised(processor, i, (i % 2 == 0) == high ? 1.0f : 0.0f);
+
+            midi.addEvent(juce::MidiMessage::noteOn(1, high ? 96 : 12, 1.0f), 0);
+        } });
+
+    scenarios.push_back({ "release-tail", "long release then silence, where decays head towards denormals",
+        [blocksPerSecond](AphexBassAudioProcessor& processor, juce::MidiBuffer& midi, int block)
+        {
+            const int cycle = blocksPerSecond * 6;
+            const int phase = block % cycle;
+            if (phase == 0)
+            {
+                setNormalised(processor, "release", 1.0f);
+                setNormalised(processor, "resonance", 1.0f);
+                midi.addEvent(juce::MidiMessage::noteOn(1, 28, 1.0f), 0);
+            }
+            else if (phase == blocksPerSecond / 4)
+            {
+                midi.addEvent(juce::MidiMessage::noteOff(1, 28), 0);
+            }
+        } });
+
+    scenarios.push_back({ "state-loads", "preset state blob loaded before every 4th block",
+        [presetStates](AphexBassAudioProcessor& processor, juce::MidiBuffer& midi, int block)
+        {
+            if (block % 4 != 0)
+                return;
+
+            const auto& state = (*presetStates)[static_cast<size_t>(block / 4) % presetStates->size()];
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            midi.addEvent(juce::MidiMessage::noteOn(1, 36 + (block / 4) % 12, 0.9f), 0);
+        } });
+
+    return scenarios;
+}
+
+ScenarioResult runScenario(const Scenario& scenario, const Options& options)
+{
+    AphexBassAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    juce::AudioBuffer<float> buffer(2, options.blockSize);
+    juce::MidiBuffer midi;
+    midi.ensureSize(4096);
+
+    // With --telemetry the tap runs as if an editor were open, drained between blocks.
+    auto& tap = processor.getTelemetry();
+    std::vector<TelemetryTap::Frame> frames(TelemetryTap::fifoFrames);
+    const bool tapAttached = options.telemetry && tap.attachConsumer();
+
+    ScenarioResult result;
+    result.blockMicros.reserve(static_cast<size_t>(options.blocks));
+
+    for (int block = 0; block < options.blocks; ++block)
+    {
+        midi.clear();
+        scenario.beforeBlock(processor, midi, block);
+
+        const auto start = Clock::now();
+        processor.processBlock(buffer, midi);
+        const auto end = Clock::now();
+
+        result.blockMicros.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+        if (tapAttached)
+            tap.pop(frames.data(), static_cast<int>(frames.size()));
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const float* samples = buffer.getReadPointer(channel);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                if (!std::isfinite(samples[i]))
+                    ++result.nonFiniteSamples;
+        }
+    }
+
+    if (tapAttached)
+    {
+        result.tapNanosPerSample = tap.getNanosecondsPerSample();
+        tap.detachConsumer();
+    }
+
+    return result;
+}
+
+// The scenario's output rendered offline with LFO retrigger on, channel after channel per block.
+std::vector<float> renderOffline(const Scenario& scenario, const Options& options, size_t noteCacheBytes,
+                                 NoteCacheStats& cacheStats)
+{
+    AphexBassAudioProcessor processor;
+    processor.setNonRealtime(true);
+    processor.setLfoRetrigger(true);
+    processor.setNoteCacheSize(noteCacheBytes);
+    processor.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    juce::AudioBuffer<float> buffer(2, options.blockSize);
+    juce::MidiBuffer midi;
+
+    std::vector<float> output;
+    output.reserve(static_cast<size_t>(options.blocks) * static_cast<size_t>(buffer.getNumChannels() * options.blockSize));
+
+    for (int block = 0; block < options.blocks; ++block)
+    {
+        midi.clear();
+        scenario.beforeBlock(processor, midi, block);
+        processor.processBlock(buffer, midi);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            output.insert(output.end(), buffer.getReadPointer(channel), buffer.getReadPointer(channel) + buffer.getNumSamples());
+    }
+
+    cacheStats = processor.getNoteCacheStats();
+    return output;
+}
+
+// Scenarios keep random state between blocks, so each render gets a freshly built copy.
+CacheCheckResult checkNoteCache(size_t scenarioIndex, const Options& options)
+{
+    constexpr size_t noteCacheBytes = 64 << 20;
+
+    CacheCheckResult result;
+    NoteCacheStats uncachedStats;
+    const auto uncached = renderOffline(makeScenarios(options)[scenarioIndex], options, 0, uncachedStats);
+    const auto cached = renderOffline(makeScenarios(options)[scenarioIndex], options, noteCacheBytes, result.cache);
+
+    for (size_t i = 0; i < uncached.size(); ++i)
+        if (std::memcmp(&uncached[i], &cached[i], sizeof(float)) != 0)
+            ++result.mismatchedSamples;
+
+    return result;
+}
+
+double percentile(const std::vector<double>& sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    const auto index = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size()))) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void printHistogram(const std::vector<double>& sorted)
+{
+    // Log-spaced buckets from 1 us, doubling, so tails are visible next to the bulk.
+    double upper = 1.0;
+    size_t index = 0;
+    while (index < sorted.size())
+    {
+        size_t count = 0;
+        while (index < sorted.size() && sorted[index] < upper)
+        {
+            ++count;
+            ++index;
+        }
+
+        if (count > 0)
+            std::printf("    < %9.0f us  %8zu\n", upper, count);
+
+        upper *= 2.0;
+    }
+}
+
+void printUsage()
+{
+    std::fputs("usage: DBassStressHarness [--sample-rate HZ] [--block-size N] [--blocks N]\n"
+               "                          [--budget-us US] [--scenario NAME] [--kernels NAME] [--telemetry] [--check-cache]\n"
+               "                          [--histogram]\n",
+               stderr);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInit;
+
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--sample-rate" && hasValue)
+            options.sampleRate = juce::jmax(8000.0, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--block-size" && hasValue)
+            options.blockSize = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--blocks" && hasValue)
+            options.blocks = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--budget-us" && hasValue)
+            options.budgetMicros = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--scenario" && hasValue)
+            options.onlyScenario = argv[++i];
+        else if (arg == "--kernels" && hasValue)
+            options.kernels = argv[++i];
+        else if (arg == "--telemetry")
+            options.telemetry = true;
+        else if (arg == "--check-cache")
+            options.checkCache = true;
+        else if (arg == "--histogram")
+            options.histogram = true;
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (options.kernels.isNotEmpty() && !bass::kernels::force(options.kernels.toRawUTF8()))
+    {
+        std::fprintf(stderr, "kernels '%s' are not available on this build or CPU\n", options.kernels.toRawUTF8());
+        return 1;
+    }
+
+    const double deadlineMicros = 1.0e6 * options.blockSize / options.sampleRate;
+    std::printf("sample rate %.0f Hz, block %d (deadline %.1f us), %d blocks per scenario, %s kernels\n\n",
+                options.sampleRate, options.blockSize, deadlineMicros, options.blocks, bass::kernels::active().name);
+    std::printf("%-14s %9s %9s %9s %9s %8s %10s\n",
+                "scenario", "p50 us", "p99 us", "p99.9 us", "max us", "max/dl", "nonfinite");
+
+    bool failed = false;
+    const auto scenarios = makeScenarios(options);
+    for (size_t index = 0; index < scenarios.size(); ++index)
+    {
+        const auto& scenario = scenarios[index];
+        if (options.onlyScenario.isNotEmpty() && options.onlyScenario != scenario.name)
+            continue;
+
+        auto result = runScenario(scenario, options);
+        auto& sorted = result.blockMicros;
+        std::sort(sorted.begin(), sorted.end());
+
+        const double worst = sorted.back();
+        const bool overBudget = options.budgetMicros > 0.0 && worst > options.budgetMicros;
+        const bool badOutput = result.nonFiniteSamples > 0;
+        failed = failed || overBudget || badOutput;
+
+        std::printf("%-14s %9.2f %9.2f %9.2f %9.2f %7.1f%% %10lld%s\n",
+                    scenario.name,
+                    percentile(sorted, 0.50), percentile(sorted, 0.99), percentile(sorted, 0.999), worst,
+                    100.0 * worst / deadlineMicros,
+                    static_cast<long long>(result.nonFiniteSamples),
+                    overBudget ? "  OVER BUDGET" : "");
+
+        if (options.telemetry)
+            std::printf("  telemetry tap: %.2f ns/sample\n", result.tapNanosPerSample);
+
+        if (options.checkCache)
+        {
+            const auto check = checkNoteCache(index, options);
+            failed = failed || check.mismatchedSamples > 0;
+            std::printf("  note cache: %llu hits, %.2f s served, %lld mismatched samples%s\n",
+                        static_cast<unsigned long long>(check.cache.hits),
+                        static_cast<double>(check.cache.samplesServed) / options.sampleRate,
+                        static_cast<long long>(check.mismatchedSamples),
+                        check.mismatchedSamples > 0 ? "  CACHE MISMATCH" : "");
+        }
+
+        if (options.histogram)
+        {
+            std::printf("  %s\n", scenario.description);
+            printHistogram(sorted);
+        }
+    }
+
+    return failed ? 1 : 0;
+}